@@ -1,9 +1,16 @@
 #include "agent.h"
 #include "neural_network.h"
+#include "engine_metrics.h"
+#include "trace.h"
+#include "dataset.h"
+#include "mapped_file.h"
+#include "zobrist.h"
+#include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 using namespace godot;
 
@@ -12,93 +19,8 @@ using namespace godot;
 void Agent::extract_features(uint8_t color) {
     if (!board) return;
 
-    // Resize and clear feature vector
     input_features.resize(NN_TOTAL_INPUTS);
-    std::fill(input_features.begin(), input_features.end(), 0.0f);
-
-    const uint8_t* squares = board->get_squares();
-    const bool mirror_board = (color == COLOR_BLACK);
-
-    // ==================== PIECE-SQUARE FEATURES (768 inputs) ====================
-    // 12 planes: P, N, B, R, Q, K (white), p, n, b, r, q, k (black)
-    // Each plane has 64 squares
-
-    // Use piece lists for faster iteration (avoid scanning empty squares)
-    const uint8_t* white_pieces = board->get_white_piece_list();
-    const uint8_t* black_pieces = board->get_black_piece_list();
-    const uint8_t white_count = board->get_white_piece_count();
-    const uint8_t black_count = board->get_black_piece_count();
-
-    // Process white pieces
-    for (uint8_t i = 0; i < white_count; i++) {
-        const uint8_t sq = white_pieces[i];
-        const uint8_t piece = squares[sq];
-        const uint8_t piece_type = GET_PIECE_TYPE(piece);
-
-        // White pieces: P=0, N=1, B=2, R=3, Q=4, K=5
-        const int plane = piece_type - 1;
-
-        // Mirror square horizontally if playing as black
-        const int feature_square = mirror_board ? mirror_square_horizontal(sq) : sq;
-
-        // Feature index = plane * 64 + square
-        const int feature_idx = plane * 64 + feature_square;
-        input_features[feature_idx] = 1.0f;
-    }
-
-    // Process black pieces
-    for (uint8_t i = 0; i < black_count; i++) {
-        const uint8_t sq = black_pieces[i];
-        const uint8_t piece = squares[sq];
-        const uint8_t piece_type = GET_PIECE_TYPE(piece);
-
-        // Black pieces: p=6, n=7, b=8, r=9, q=10, k=11
-        const int plane = (piece_type - 1) + 6;
-
-        // Mirror square horizontally if playing as black
-        const int feature_square = mirror_board ? mirror_square_horizontal(sq) : sq;
-
-        // Feature index = plane * 64 + square
-        const int feature_idx = plane * 64 + feature_square;
-        input_features[feature_idx] = 1.0f;
-    }
-
-    // ==================== CASTLING RIGHTS (4 inputs) ====================
-    const bool* castling = board->get_castling_rights();
-    int castling_offset = NN_PIECE_INPUTS;  // 768
-
-    if (mirror_board) {
-        // Mirror castling rights horizontally: swap white and black castling rights
-        input_features[castling_offset + 0] = castling[2] ? 1.0f : 0.0f;  // Black Kingside → position 0
-        input_features[castling_offset + 1] = castling[3] ? 1.0f : 0.0f;  // Black Queenside → position 1
-        input_features[castling_offset + 2] = castling[0] ? 1.0f : 0.0f;  // White Kingside → position 2
-        input_features[castling_offset + 3] = castling[1] ? 1.0f : 0.0f;  // White Queenside → position 3
-    } else {
-        input_features[castling_offset + 0] = castling[0] ? 1.0f : 0.0f;  // White Kingside
-        input_features[castling_offset + 1] = castling[1] ? 1.0f : 0.0f;  // White Queenside
-        input_features[castling_offset + 2] = castling[2] ? 1.0f : 0.0f;  // Black Kingside
-        input_features[castling_offset + 3] = castling[3] ? 1.0f : 0.0f;  // Black Queenside
-    }
-
-    // ==================== SIDE TO MOVE (1 input) ====================
-    int turn_offset = castling_offset + NN_CASTLING_INPUTS;  // 772
-    if (mirror_board) {
-        // From black's mirrored perspective: 1.0 = black to move, 0.0 = white to move
-        input_features[turn_offset] = (board->get_turn() == 1) ? 1.0f : 0.0f;
-    } else {
-        input_features[turn_offset] = (board->get_turn() == 0) ? 1.0f : 0.0f;  // 1.0 = white to move
-    }
-
-    // ==================== EN PASSANT (8 inputs, one-hot by file) ====================
-    int ep_offset = turn_offset + NN_TURN_INPUT;  // 773
-    uint8_t ep_target = board->get_en_passant_target();
-    if (ep_target != 255) {
-        // Mirror en passant square if playing as black
-        uint8_t mirrored_ep = mirror_board ? mirror_square_horizontal(ep_target) : ep_target;
-        int ep_file = mirrored_ep % 8;
-        input_features[ep_offset + ep_file] = 1.0f;
-    }
-    // If no en passant, all 8 inputs remain 0.0
+    Features::extract(*board, color, input_features.data());
 }
 
 // ==================== STATIC MEMBER DEFINITIONS ====================
@@ -107,6 +29,8 @@ TTEntry* Agent::tt_table = nullptr;
 bool Agent::tt_initialized = false;
 uint8_t Agent::tt_age = 0;
 
+EvalCache* Agent::eval_cache = nullptr;
+
 int16_t Agent::mvv_lva_table[7][7];
 bool Agent::mvv_lva_initialized = false;
 
@@ -176,6 +100,20 @@ void Agent::tt_store(uint64_t key, int score, int depth, int flag, uint8_t best_
     }
 }
 
+// Mate scores count plies from the root; the TT stores them counted from the
+// entry's own node so a hit at another ply still reports the right distance
+static inline int score_to_tt(int score, int ply) {
+    if (score >= MATE_BOUND) return score + ply;
+    if (score <= -MATE_BOUND) return score - ply;
+    return score;
+}
+
+static inline int score_from_tt(int score, int ply) {
+    if (score >= MATE_BOUND) return score - ply;
+    if (score <= -MATE_BOUND) return score + ply;
+    return score;
+}
+
 TTEntry* Agent::tt_probe(uint64_t key) const {
     if (!tt_table) return nullptr;
     
@@ -189,6 +127,324 @@ TTEntry* Agent::tt_probe(uint64_t key) const {
     return nullptr;
 }
 
+uint32_t Agent::tt_fill_permille() {
+    if (!tt_table) return 0;
+
+    // Sample the first 1000 slots, counting entries written by the current search
+    uint32_t used = 0;
+    for (int i = 0; i < 1000; i++) {
+        if (tt_table[i].key != 0 && tt_table[i].age == tt_age) {
+            used++;
+        }
+    }
+    return used;
+}
+
+// ==================== HASH PERSISTENCE ====================
+
+uint64_t Agent::tt_key_check() {
+    Zobrist::init();
+    return Zobrist::piece_keys[0][0] ^ Zobrist::piece_keys[11][63] ^
+           Zobrist::castling_keys[8] ^ Zobrist::en_passant_keys[7] ^ Zobrist::side_key;
+}
+
+// Entry records are packed field by field (no struct padding on disk)
+static inline void pack_tt_entry(const TTEntry &entry, uint8_t *out) {
+    memcpy(out, &entry.key, 8);
+    memcpy(out + 8, &entry.score, 2);
+    out[10] = static_cast<uint8_t>(entry.depth);
+    out[11] = entry.flag;
+    out[12] = entry.best_from;
+    out[13] = entry.best_to;
+}
+
+static inline void unpack_tt_entry(const uint8_t *in, TTEntry &entry) {
+    memcpy(&entry.key, in, 8);
+    memcpy(&entry.score, in + 8, 2);
+    entry.depth = static_cast<int8_t>(in[10]);
+    entry.flag = in[11];
+    entry.best_from = in[12];
+    entry.best_to = in[13];
+}
+
+bool Agent::save_hash(const String &path, int min_depth) {
+    TRACE_SCOPE("hash_save");
+
+    if (!tt_table) {
+        UtilityFunctions::print("Error: Transposition table is not initialized");
+        return false;
+    }
+
+    CharString native = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+    FILE *file = fopen(native.get_data(), "wb");
+    if (!file) {
+        UtilityFunctions::print("Error: Cannot open file for writing: ", path);
+        return false;
+    }
+
+    TTFileHeader header;
+    memcpy(header.magic, TT_FILE_MAGIC, 4);
+    header.version = TT_FILE_VERSION;
+    header.entry_size = TT_FILE_ENTRY_SIZE;
+    header.min_depth = static_cast<uint32_t>(std::max(min_depth, 0));
+    header.key_check = tt_key_check();
+    header.entry_count = 0;
+    for (size_t i = 0; i < TT_SIZE; i++) {
+        if (tt_table[i].key != 0 && tt_table[i].depth >= min_depth) {
+            header.entry_count++;
+        }
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // Stream through a fixed buffer instead of staging the whole table
+    const size_t BATCH = 4096;
+    uint8_t buffer[BATCH * TT_FILE_ENTRY_SIZE];
+    size_t buffered = 0;
+    for (size_t i = 0; i < TT_SIZE && ok; i++) {
+        const TTEntry &entry = tt_table[i];
+        if (entry.key == 0 || entry.depth < min_depth) continue;
+
+        pack_tt_entry(entry, buffer + buffered * TT_FILE_ENTRY_SIZE);
+        if (++buffered == BATCH) {
+            ok = fwrite(buffer, TT_FILE_ENTRY_SIZE, buffered, file) == buffered;
+            buffered = 0;
+        }
+    }
+    if (ok && buffered > 0) {
+        ok = fwrite(buffer, TT_FILE_ENTRY_SIZE, buffered, file) == buffered;
+    }
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        UtilityFunctions::print("Error: Failed writing hash file: ", path);
+        return false;
+    }
+
+    UtilityFunctions::print("Saved ", (int64_t)header.entry_count, " hash entries (depth >= ", min_depth, ") to ", path);
+    return true;
+}
+
+int64_t Agent::load_hash(const String &path) {
+    TRACE_SCOPE("hash_load");
+
+    init_tt();
+
+    CharString native = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+    MappedFile mapped;
+    if (!mapped.open(native.get_data())) {
+        UtilityFunctions::print("Error: Cannot open hash file: ", path);
+        return -1;
+    }
+
+    TTFileHeader header;
+    if (mapped.size() < sizeof(header)) {
+        UtilityFunctions::print("Error: Hash file is truncated: ", path);
+        return -1;
+    }
+    memcpy(&header, mapped.data(), sizeof(header));
+
+    if (memcmp(header.magic, TT_FILE_MAGIC, 4) != 0 ||
+        header.version != TT_FILE_VERSION ||
+        header.entry_size != TT_FILE_ENTRY_SIZE) {
+        UtilityFunctions::print("Error: Not a compatible hash file: ", path);
+        return -1;
+    }
+    if (header.key_check != tt_key_check()) {
+        UtilityFunctions::print("Error: Hash file was saved with different Zobrist keys: ", path);
+        return -1;
+    }
+    if (header.entry_count > (mapped.size() - sizeof(header)) / TT_FILE_ENTRY_SIZE) {
+        UtilityFunctions::print("Error: Hash file is truncated: ", path);
+        return -1;
+    }
+
+    // Loaded entries belong to the current age, so the next search may
+    // overwrite them like any entry from the previous search
+    const uint8_t *record = mapped.data() + sizeof(header);
+    int64_t stored = 0;
+    for (uint64_t i = 0; i < header.entry_count; i++, record += TT_FILE_ENTRY_SIZE) {
+        TTEntry loaded;
+        unpack_tt_entry(record, loaded);
+        if (loaded.key == 0 || loaded.flag > TT_FLAG_BETA) continue;
+
+        TTEntry &slot = tt_table[loaded.key % TT_SIZE];
+        if (slot.key != 0 && slot.depth > loaded.depth) continue;
+
+        loaded.age = tt_age;
+        loaded.padding = 0;
+        slot = loaded;
+        stored++;
+    }
+
+    UtilityFunctions::print("Loaded ", stored, " of ", (int64_t)header.entry_count, " hash entries from ", path);
+    return stored;
+}
+
+// ==================== PERSISTENT RESULT CACHE ====================
+
+bool Agent::open_eval_cache(const String &path) {
+    if (!eval_cache) {
+        eval_cache = new EvalCache();
+    }
+
+    CharString native = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+    if (!eval_cache->open(native.get_data())) {
+        UtilityFunctions::print("Error: Cannot open evaluation cache: ", path);
+        return false;
+    }
+
+    UtilityFunctions::print("Evaluation cache opened with ", (int64_t)eval_cache->get_count(), " entries: ", path);
+    return true;
+}
+
+void Agent::close_eval_cache() {
+    if (eval_cache) {
+        eval_cache->close();
+    }
+}
+
+Dictionary Agent::get_eval_cache_stats() const {
+    Dictionary stats;
+    bool open = eval_cache && eval_cache->is_open();
+    stats["open"] = open;
+    stats["entries"] = open ? (int64_t)eval_cache->get_count() : (int64_t)0;
+    stats["hits"] = open ? (int64_t)eval_cache->get_hits() : (int64_t)0;
+    stats["misses"] = open ? (int64_t)eval_cache->get_misses() : (int64_t)0;
+    return stats;
+}
+
+uint32_t Agent::evaluator_checksum() {
+    return (use_neural_network && network_initialized) ? get_model_checksum() : 0;
+}
+
+static String move_to_uci(const FastMove &m) {
+    static const char PROMOTION_CHARS[7] = {0, 0, 'n', 'b', 'r', 'q', 0};
+
+    char from[3], to[3];
+    Position::square_name(m.from, from);
+    Position::square_name(m.to, to);
+    String uci = String(from) + String(to);
+    const uint8_t promo_piece = (m.flags >> 3) & 7;
+    if (promo_piece) uci += String::chr(PROMOTION_CHARS[promo_piece]);
+    return uci;
+}
+
+// PV moves in cache records (EVAL_CACHE_PV): from | to << 6 | promotion piece << 12
+static inline uint16_t pack_pv_move(const FastMove &m) {
+    return static_cast<uint16_t>(m.from | (m.to << 6) | (((m.flags >> 3) & 7) << 12));
+}
+
+static inline FastMove unpack_pv_move(uint16_t packed) {
+    FastMove m = {};
+    m.from = packed & 63;
+    m.to = (packed >> 6) & 63;
+    m.flags = static_cast<uint8_t>(((packed >> 12) & 7) << 3);
+    return m;
+}
+
+static inline uint64_t pv_record_hash(uint64_t hash, int chunk) {
+    return hash ^ (static_cast<uint64_t>(chunk) + 1) * EVAL_CACHE_PV_SALT;
+}
+
+bool Agent::lookup_search_result(int driver, int depth, Dictionary &result) {
+    if (!eval_cache || !eval_cache->is_open() || depth > INT8_MAX) return false;
+
+    const uint64_t hash = board->get_hash();
+    const uint32_t checksum = evaluator_checksum();
+    const int variant = search_variant(driver);
+    EvalCacheRecord record;
+    if (!eval_cache->lookup(hash, checksum, depth, EVAL_CACHE_SEARCH + variant, record)) {
+        return false;
+    }
+
+    // This call searched nothing: the stats must not describe the previous search.
+    // Not published to EngineMetrics, whose monitors follow completed searches
+    begin_search_stats();
+
+    result["from"] = record.best_from;
+    result["to"] = record.best_to;
+    result["score"] = record.score;
+    result["depth"] = depth;
+    result["cached"] = true;
+
+    if (driver == SEARCH_DRIVER_ITERATIVE) {
+        Array pv;
+        for (int chunk = 0; eval_cache->lookup(pv_record_hash(hash, chunk), checksum, depth, EVAL_CACHE_PV + variant, record); chunk++) {
+            const uint32_t words[2] = {static_cast<uint32_t>(record.score), record.reserved};
+            bool ended = false;
+            for (int i = 0; i < EVAL_CACHE_PV_MOVES_PER_RECORD && !ended; i++) {
+                const uint16_t packed = static_cast<uint16_t>(words[i / 2] >> ((i % 2) * 16));
+                ended = (packed == 0);
+                if (!ended) pv.append(move_to_uci(unpack_pv_move(packed)));
+            }
+            if (ended) break;
+        }
+        result["pv"] = pv;
+    }
+    return true;
+}
+
+void Agent::store_search_result(int driver, int depth, const Dictionary &result, const std::vector<FastMove> *pv) {
+    if (!eval_cache || !eval_cache->is_open() || depth > INT8_MAX || result.is_empty()) return;
+
+    const int variant = search_variant(driver);
+    EvalCacheRecord record = {};
+    record.hash = board->get_hash();
+    record.model_checksum = evaluator_checksum();
+    record.score = result["score"];
+    record.depth = static_cast<int8_t>(depth);
+    record.kind = static_cast<uint8_t>(EVAL_CACHE_SEARCH + variant);
+    record.best_from = static_cast<uint8_t>(static_cast<int>(result["from"]));
+    record.best_to = static_cast<uint8_t>(static_cast<int>(result["to"]));
+    eval_cache->insert(record);
+
+    if (!pv) return;
+
+    // Chunks of EVAL_CACHE_PV_MOVES_PER_RECORD moves; a full last chunk is
+    // followed by an empty one to end the PV
+    const size_t length = pv->size();
+    for (size_t start = 0; start <= length; start += EVAL_CACHE_PV_MOVES_PER_RECORD) {
+        uint32_t words[2] = {0, 0};
+        for (size_t i = 0; i < EVAL_CACHE_PV_MOVES_PER_RECORD && start + i < length; i++) {
+            words[i / 2] |= static_cast<uint32_t>(pack_pv_move((*pv)[start + i])) << ((i % 2) * 16);
+        }
+
+        EvalCacheRecord chunk = {};
+        chunk.hash = pv_record_hash(record.hash, static_cast<int>(start / EVAL_CACHE_PV_MOVES_PER_RECORD));
+        chunk.model_checksum = record.model_checksum;
+        chunk.score = static_cast<int32_t>(words[0]);
+        chunk.reserved = words[1];
+        chunk.depth = record.depth;
+        chunk.kind = static_cast<uint8_t>(EVAL_CACHE_PV + variant);
+        chunk.best_from = 255;
+        chunk.best_to = 255;
+        eval_cache->insert(chunk);
+    }
+}
+
+// ==================== SEARCH STATISTICS ====================
+
+static uint64_t now_usec() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Agent::begin_search_stats() {
+    nodes_searched = 0;
+    search_tt_probes = 0;
+    search_tt_hits = 0;
+    search_start_usec = now_usec();
+}
+
+void Agent::end_search_stats() {
+    uint64_t elapsed = now_usec() - search_start_usec;
+
+    EngineMetrics::tt_probes.fetch_add(search_tt_probes, std::memory_order_relaxed);
+    EngineMetrics::tt_hits.fetch_add(search_tt_hits, std::memory_order_relaxed);
+    EngineMetrics::record_search(nodes_searched, elapsed, tt_fill_permille());
+}
+
 // ==================== KILLER MOVES ====================
 
 void Agent::clear_killers() {
@@ -334,20 +590,36 @@ void Agent::sort_moves(MoveList &moves) const {
 // ==================== ALPHA-BETA SEARCH ====================
 
 int Agent::minimax_internal(int depth, int ply, int alpha, int beta, bool is_maximizing) {
+    nodes_searched++;
+    
+    // Dead material: neither side can mate, no need to search it out
+    if (board->is_insufficient_material()) {
+        return STALEMATE_SCORE;
+    }
+    
+    // Mate distance pruning: nothing here beats mating or being mated on this ply
+    alpha = std::max(alpha, -CHECKMATE_SCORE + ply);
+    beta = std::min(beta, CHECKMATE_SCORE - ply);
+    if (alpha >= beta) {
+        return alpha;
+    }
     int original_alpha = alpha;
+    int original_beta = beta;
     
     // TT Probe
     uint64_t hash = board->get_hash();
     TTEntry* tt_entry = tt_probe(hash);
     uint8_t tt_best_from = 255;
     uint8_t tt_best_to = 255;
+    search_tt_probes++;
     
     if (tt_entry) {
+        search_tt_hits++;
         tt_best_from = tt_entry->best_from;
         tt_best_to = tt_entry->best_to;
         
         if (tt_entry->depth >= depth) {
-            int tt_score = tt_entry->score;
+            int tt_score = score_from_tt(tt_entry->score, ply);
             
             switch (tt_entry->flag) {
                 case TT_FLAG_EXACT:
@@ -387,10 +659,32 @@ int Agent::minimax_internal(int depth, int ply, int alpha, int beta, bool is_max
         uint8_t eval_color = (root_color == 0) ? COLOR_WHITE : COLOR_BLACK;
 
         int score = evaluate(eval_color);
-        tt_store(hash, score, 0, TT_FLAG_EXACT, 255, 255);
+        
+        // KNNvK, minor vs minor: mates exist but can't be forced, so the
+        // material edge counts for little. Mates themselves are found above
+        if (board->is_drawish_material()) {
+            score /= DRAWISH_EVAL_DIVISOR;
+        }
+        tt_store(hash, score_to_tt(score, ply), 0, TT_FLAG_EXACT, 255, 255);
         return score;
     }
     
+    // No TT move: ordering falls back to MVV-LVA, killers and history, which
+    // is where deep subtrees blow up
+    if (tt_best_from == 255 && depth >= TT_MISS_MIN_DEPTH && !in_check) {
+        if (tt_miss_strategy == TT_MISS_IIR) {
+            // The reduced search leaves a TT move for the next iteration
+            depth--;
+        } else if (tt_miss_strategy == TT_MISS_IID) {
+            minimax_internal(depth - IID_REDUCTION, ply, alpha, beta, is_maximizing);
+            TTEntry* iid_entry = tt_probe(hash);
+            if (iid_entry) {
+                tt_best_from = iid_entry->best_from;
+                tt_best_to = iid_entry->best_to;
+            }
+        }
+    }
+    
     // Generate and sort moves
     MoveList moves;
     board->generate_all_pseudo_legal(moves);
@@ -400,9 +694,7 @@ int Agent::minimax_internal(int depth, int ply, int alpha, int beta, bool is_max
     uint8_t current_color = current_turn;
     
     uint8_t ep_before = board->get_en_passant_target();
-    bool castling_before[4];
-    const bool* cr = board->get_castling_rights();
-    for (int i = 0; i < 4; i++) castling_before[i] = cr[i];
+    uint8_t castling_before = board->get_castling_rights();
     uint64_t hash_before = hash;
     
     uint8_t best_move_from = 255;
@@ -441,7 +733,7 @@ int Agent::minimax_internal(int depth, int ply, int alpha, int beta, bool is_max
                         update_history(m.from, m.to, depth);
                     }
                     
-                    tt_store(hash_before, best_score, depth, TT_FLAG_BETA, best_move_from, best_move_to);
+                    tt_store(hash_before, score_to_tt(best_score, ply), depth, TT_FLAG_BETA, best_move_from, best_move_to);
                     return best_score;
                 }
             }
@@ -450,7 +742,7 @@ int Agent::minimax_internal(int depth, int ply, int alpha, int beta, bool is_max
         }
         
         int tt_flag = (best_score <= original_alpha) ? TT_FLAG_ALPHA : TT_FLAG_EXACT;
-        tt_store(hash_before, best_score, depth, tt_flag, best_move_from, best_move_to);
+        tt_store(hash_before, score_to_tt(best_score, ply), depth, tt_flag, best_move_from, best_move_to);
         
         return best_score;
     } else {
@@ -486,7 +778,7 @@ int Agent::minimax_internal(int depth, int ply, int alpha, int beta, bool is_max
                         update_history(m.from, m.to, depth);
                     }
                     
-                    tt_store(hash_before, best_score, depth, TT_FLAG_ALPHA, best_move_from, best_move_to);
+                    tt_store(hash_before, score_to_tt(best_score, ply), depth, TT_FLAG_ALPHA, best_move_from, best_move_to);
                     return best_score;
                 }
             }
@@ -494,7 +786,8 @@ int Agent::minimax_internal(int depth, int ply, int alpha, int beta, bool is_max
             board->unmake_move_fast(m, ep_before, castling_before, hash_before);
         }
         
-        tt_store(hash_before, best_score, depth, TT_FLAG_EXACT, best_move_from, best_move_to);
+        int tt_flag = (best_score >= original_beta) ? TT_FLAG_BETA : TT_FLAG_EXACT;
+        tt_store(hash_before, score_to_tt(best_score, ply), depth, tt_flag, best_move_from, best_move_to);
         
         return best_score;
     }
@@ -506,13 +799,34 @@ int Agent::evaluate(uint8_t color) {
     if (!board) return 0;
 
     if (use_neural_network && network_initialized) {
+        // Network evaluations are worth a cache lookup (material is cheaper than one)
+        const bool cached = eval_cache && eval_cache->is_open();
+        const uint8_t kind = (color == COLOR_BLACK) ? EVAL_CACHE_EVAL_BLACK : EVAL_CACHE_EVAL_WHITE;
+        if (cached) {
+            EvalCacheRecord record;
+            if (eval_cache->lookup(board->get_hash(), get_model_checksum(), 0, kind, record)) {
+                return record.score;
+            }
+        }
+
         // Extract features and run neural network
         // Board will be mirrored if color is COLOR_BLACK
         extract_features(color);
         float nn_score = forward_pass(input_features);
 
-        // Convert float score to centipawns
-        return static_cast<int>(nn_score);
+        // Convert float score to centipawns, kept clear of the mate range
+        int score = static_cast<int>(std::clamp(nn_score, static_cast<float>(-MATE_BOUND + 1), static_cast<float>(MATE_BOUND - 1)));
+        if (cached) {
+            EvalCacheRecord record = {};
+            record.hash = board->get_hash();
+            record.model_checksum = get_model_checksum();
+            record.score = score;
+            record.kind = kind;
+            record.best_from = 255;
+            record.best_to = 255;
+            eval_cache->insert(record);
+        }
+        return score;
     } else {
         // Use simple material evaluation
         return evaluate_material();
@@ -591,10 +905,12 @@ void Agent::set_use_neural_network(bool use_nn) {
 Dictionary Agent::get_best_move(int depth) {
     Dictionary result;
     if (!board) return result;
+    if (lookup_search_result(SEARCH_DRIVER_FIXED_DEPTH, depth, result)) return result;
     
     clear_killers();
     clear_history();
     tt_new_search();
+    begin_search_stats();
     
     MoveList moves;
     board->generate_all_pseudo_legal(moves);
@@ -610,9 +926,7 @@ Dictionary Agent::get_best_move(int depth) {
     bool is_maximizing = (current_color == 0);
     
     uint8_t ep_before = board->get_en_passant_target();
-    bool castling_before[4];
-    const bool* cr = board->get_castling_rights();
-    for (int i = 0; i < 4; i++) castling_before[i] = cr[i];
+    uint8_t castling_before = board->get_castling_rights();
     uint64_t hash_before = board->get_hash();
     
     int alpha = INT_MIN;
@@ -624,6 +938,7 @@ Dictionary Agent::get_best_move(int depth) {
     
     for (int i = 0; i < moves.count; i++) {
         FastMove &m = moves.moves[i];
+        TRACE_SCOPE_ARG("root_move", m.from * 64 + m.to);
         
         board->make_move_fast(m);
         
@@ -661,108 +976,355 @@ Dictionary Agent::get_best_move(int depth) {
         result["from"] = best_from;
         result["to"] = best_to;
         result["score"] = best_score;
+        store_search_result(SEARCH_DRIVER_FIXED_DEPTH, depth, result);
     }
     
+    end_search_stats();
     return result;
 }
 
-Dictionary Agent::run_iterative_deepening(int max_depth) {
+// ==================== ROOT MOVES ====================
+
+void Agent::init_root_moves() {
+    root_moves.clear();
+
+    MoveList moves;
+    board->generate_all_pseudo_legal(moves);
+
+    TTEntry* tt_entry = tt_probe(board->get_hash());
+    uint8_t tt_best_from = (tt_entry) ? tt_entry->best_from : 255;
+    uint8_t tt_best_to = (tt_entry) ? tt_entry->best_to : 255;
+
+    score_moves(moves, tt_best_from, tt_best_to, 0);
+    sort_moves(moves);
+
+    uint8_t current_color = board->get_turn();
+    uint8_t ep_before = board->get_en_passant_target();
+    uint8_t castling_before = board->get_castling_rights();
+    uint64_t hash_before = board->get_hash();
+    int worst = (current_color == 0) ? INT_MIN : INT_MAX;
+
+    for (int i = 0; i < moves.count; i++) {
+        FastMove &m = moves.moves[i];
+        board->make_move_fast(m);
+        uint8_t our_king = board->get_king_pos(current_color);
+        if (!board->is_square_attacked_fast(our_king, 1 - current_color)) {
+            root_moves.push_back(RootMove{m, worst, false, 0, {m}});
+        }
+        board->unmake_move_fast(m, ep_before, castling_before, hash_before);
+    }
+}
+
+void Agent::sort_root_moves(bool is_maximizing, int best_index) {
+    std::rotate(root_moves.begin(), root_moves.begin() + best_index, root_moves.begin() + best_index + 1);
+    std::stable_sort(root_moves.begin() + 1, root_moves.end(), [is_maximizing](const RootMove &a, const RootMove &b) {
+        if (a.exact != b.exact) return a.exact;
+        if (a.score != b.score) return is_maximizing ? a.score > b.score : a.score < b.score;
+        return a.nodes > b.nodes;
+    });
+}
+
+void Agent::extract_pv(RootMove &root_move, int max_length) {
+    root_move.pv.assign(1, root_move.move);
+
+    Position pos = board->after(root_move.move);
+    std::vector<uint64_t> seen = {board->get_hash()};
+
+    while (static_cast<int>(root_move.pv.size()) < max_length) {
+        const uint64_t hash = pos.get_hash();
+        if (std::find(seen.begin(), seen.end(), hash) != seen.end()) break;
+        seen.push_back(hash);
+
+        TTEntry* tt_entry = tt_probe(hash);
+        if (!tt_entry || tt_entry->best_from == 255) break;
+
+        MoveList moves;
+        Position scratch = pos;
+        scratch.generate_legal_moves(moves);
+
+        int found = -1;
+        for (int i = 0; i < moves.count && found < 0; i++) {
+            if (moves.moves[i].from == tt_entry->best_from && moves.moves[i].to == tt_entry->best_to) found = i;
+        }
+        if (found < 0) break;
+
+        root_move.pv.push_back(moves.moves[found]);
+        pos = pos.after(moves.moves[found]);
+    }
+}
+
+Dictionary Agent::run_iterative_deepening(int max_depth, int64_t time_limit_ms) {
     Dictionary best_result;
     if (!board) return best_result;
+    if (lookup_search_result(SEARCH_DRIVER_ITERATIVE, max_depth, best_result)) return best_result;
     
     clear_killers();
     clear_history();
     tt_new_search();
+    begin_search_stats();
     
-    for (int current_depth = 1; current_depth <= max_depth; current_depth++) {
+    init_root_moves();
+    
+    uint8_t current_color = board->get_turn();
+    bool is_maximizing = (current_color == 0);
+    
+    uint8_t ep_before = board->get_en_passant_target();
+    uint8_t castling_before = board->get_castling_rights();
+    uint64_t hash_before = board->get_hash();
+    
+    const uint64_t time_limit_usec = (time_limit_ms > 0) ? static_cast<uint64_t>(time_limit_ms) * 1000 : 0;
+    bool out_of_time = false;
+    FastMove previous_best = {};
+    int stable_iterations = 0;
+    
+    for (int current_depth = 1; current_depth <= max_depth && !root_moves.empty(); current_depth++) {
+        TRACE_SCOPE_ARG("id_iteration", current_depth);
         Dictionary result;
         
-        MoveList moves;
-        board->generate_all_pseudo_legal(moves);
-        
-        TTEntry* tt_entry = tt_probe(board->get_hash());
-        uint8_t tt_best_from = (tt_entry) ? tt_entry->best_from : 255;
-        uint8_t tt_best_to = (tt_entry) ? tt_entry->best_to : 255;
-        
-        score_moves(moves, tt_best_from, tt_best_to, 0);
-        sort_moves(moves);
-        
-        uint8_t current_color = board->get_turn();
-        bool is_maximizing = (current_color == 0);
-        
-        uint8_t ep_before = board->get_en_passant_target();
-        bool castling_before[4];
-        const bool* cr = board->get_castling_rights();
-        for (int i = 0; i < 4; i++) castling_before[i] = cr[i];
-        uint64_t hash_before = board->get_hash();
-        
         int alpha = INT_MIN;
         int beta = INT_MAX;
+        uint64_t iteration_start_nodes = nodes_searched;
+        int best_index = 0;
         
-        int best_score = is_maximizing ? INT_MIN : INT_MAX;
-        int best_from = -1;
-        int best_to = -1;
-        
-        for (int i = 0; i < moves.count; i++) {
-            FastMove &m = moves.moves[i];
+        for (size_t i = 0; i < root_moves.size(); i++) {
+            RootMove &root_move = root_moves[i];
+            FastMove &m = root_move.move;
+            TRACE_SCOPE_ARG("root_move", m.from * 64 + m.to);
             
+            uint64_t nodes_before = nodes_searched;
             board->make_move_fast(m);
+            int score = minimax_internal(current_depth - 1, 1, alpha, beta, !is_maximizing);
+            board->unmake_move_fast(m, ep_before, castling_before, hash_before);
             
-            uint8_t our_king = board->get_king_pos(current_color);
-            if (!board->is_square_attacked_fast(our_king, 1 - current_color)) {
-                int score = minimax_internal(current_depth - 1, 1, alpha, beta, !is_maximizing);
-                
+            // The first move has the full window; later ones are exact only if they improve on it
+            bool improves = (i == 0) || (is_maximizing ? score > alpha : score < beta);
+            
+            root_move.score = score;
+            root_move.exact = improves;
+            root_move.nodes = nodes_searched - nodes_before;
+            
+            if (improves) {
+                best_index = static_cast<int>(i);
                 if (is_maximizing) {
-                    if (score > best_score) {
-                        best_score = score;
-                        best_from = m.from;
-                        best_to = m.to;
-                    }
-                    if (score > alpha) {
-                        alpha = score;
-                    }
+                    alpha = score;
                 } else {
-                    if (score < best_score) {
-                        best_score = score;
-                        best_from = m.from;
-                        best_to = m.to;
-                    }
-                    if (score < beta) {
-                        beta = score;
-                    }
+                    beta = score;
                 }
             }
-            
-            board->unmake_move_fast(m, ep_before, castling_before, hash_before);
         }
         
-        if (best_from >= 0) {
-            tt_store(hash_before, best_score, current_depth, TT_FLAG_EXACT, best_from, best_to);
+        sort_root_moves(is_maximizing, best_index);
+        
+        RootMove &best = root_moves[0];
+        
+        // Stability counts from the first searched best move
+        const bool same_best = current_depth > 1 && best.move.from == previous_best.from &&
+                               best.move.to == previous_best.to && best.move.flags == previous_best.flags;
+        stable_iterations = same_best ? stable_iterations + 1 : 1;
+        previous_best = best.move;
+        
+        tt_store(hash_before, best.score, current_depth, TT_FLAG_EXACT, best.move.from, best.move.to);
+        extract_pv(best, current_depth);
+        
+        Array pv;
+        for (const FastMove &m : best.pv) {
+            pv.append(move_to_uci(m));
+        }
+        
+        result["from"] = static_cast<int>(best.move.from);
+        result["to"] = static_cast<int>(best.move.to);
+        result["score"] = best.score;
+        result["depth"] = current_depth;
+        result["pv"] = pv;
+        
+        best_result = result;
+        
+        // Early termination on checkmate
+        if (best.score >= MATE_BOUND || best.score <= -MATE_BOUND) {
+            break;
+        }
+        
+        if (time_limit_usec > 0 && current_depth < max_depth) {
+            uint64_t iteration_nodes = nodes_searched - iteration_start_nodes;
+            bool settled = stable_iterations >= ROOT_STABLE_ITERATIONS &&
+                           best.nodes * 100 >= iteration_nodes * ROOT_STABLE_EFFORT_PERCENT;
+            uint64_t elapsed = now_usec() - search_start_usec;
             
-            result["from"] = best_from;
-            result["to"] = best_to;
-            result["score"] = best_score;
-            result["depth"] = current_depth;
+            if (elapsed * 100 >= time_limit_usec * ROOT_TIME_NEXT_ITERATION_PERCENT ||
+                (settled && elapsed * 100 >= time_limit_usec * ROOT_TIME_STABLE_PERCENT)) {
+                out_of_time = true;
+                break;
+            }
+        }
+    }
+    
+    // A shallower result cut short by the clock is not the max_depth answer
+    if (!out_of_time) {
+        store_search_result(SEARCH_DRIVER_ITERATIVE, max_depth, best_result, root_moves.empty() ? nullptr : &root_moves[0].pv);
+    }
+    end_search_stats();
+    return best_result;
+}
+
+// ==================== MTD(f) ====================
+
+int Agent::search_root(int depth, int alpha, int beta, int &best_from, int &best_to) {
+    MoveList moves;
+    board->generate_all_pseudo_legal(moves);
+    
+    TTEntry* tt_entry = tt_probe(board->get_hash());
+    uint8_t tt_best_from = (tt_entry) ? tt_entry->best_from : 255;
+    uint8_t tt_best_to = (tt_entry) ? tt_entry->best_to : 255;
+    
+    score_moves(moves, tt_best_from, tt_best_to, 0);
+    sort_moves(moves);
+    
+    uint8_t current_color = board->get_turn();
+    bool is_maximizing = (current_color == 0);
+    
+    uint8_t ep_before = board->get_en_passant_target();
+    uint8_t castling_before = board->get_castling_rights();
+    uint64_t hash_before = board->get_hash();
+    const int original_alpha = alpha;
+    const int original_beta = beta;
+    
+    int best_score = is_maximizing ? INT_MIN : INT_MAX;
+    best_from = -1;
+    best_to = -1;
+    
+    for (int i = 0; i < moves.count; i++) {
+        FastMove &m = moves.moves[i];
+        board->make_move_fast(m);
+        
+        uint8_t our_king = board->get_king_pos(current_color);
+        if (!board->is_square_attacked_fast(our_king, 1 - current_color)) {
+            int score = minimax_internal(depth - 1, 1, alpha, beta, !is_maximizing);
             
-            best_result = result;
+            if (is_maximizing ? (score > best_score) : (score < best_score)) {
+                best_score = score;
+                best_from = m.from;
+                best_to = m.to;
+            }
+            if (is_maximizing) alpha = std::max(alpha, score);
+            else beta = std::min(beta, score);
+        }
+        
+        board->unmake_move_fast(m, ep_before, castling_before, hash_before);
+        if (alpha >= beta) break;
+    }
+    
+    if (best_from >= 0) {
+        int tt_flag = TT_FLAG_EXACT;
+        if (best_score <= original_alpha) tt_flag = TT_FLAG_ALPHA;
+        else if (best_score >= original_beta) tt_flag = TT_FLAG_BETA;
+        tt_store(hash_before, best_score, depth, tt_flag, best_from, best_to);
+    }
+    return best_score;
+}
+
+Dictionary Agent::run_mtdf(int max_depth) {
+    Dictionary best_result;
+    if (!board) return best_result;
+    if (lookup_search_result(SEARCH_DRIVER_MTDF, max_depth, best_result)) return best_result;
+    
+    clear_killers();
+    clear_history();
+    tt_new_search();
+    begin_search_stats();
+    
+    const bool is_maximizing = (board->get_turn() == 0);
+    int guess = evaluate_material();
+    int64_t passes = 0;
+    
+    for (int current_depth = 1; current_depth <= max_depth; current_depth++) {
+        TRACE_SCOPE_ARG("mtdf_iteration", current_depth);
+        
+        // Zero-window passes close [lower, upper] on the value, starting from
+        // the previous depth's value. The best move comes from a pass that
+        // proved the side to move can reach its bound
+        int lower = -CHECKMATE_SCORE - 1;
+        int upper = CHECKMATE_SCORE + 1;
+        int best_from = -1;
+        int best_to = -1;
+        
+        while (lower < upper) {
+            const int beta = (guess == lower) ? guess + 1 : guess;
+            int from, to;
+            guess = search_root(current_depth, beta - 1, beta, from, to);
+            passes++;
             
-            // Early termination on checkmate
-            if (best_score >= CHECKMATE_SCORE - 100 || best_score <= -CHECKMATE_SCORE + 100) {
-                break;
+            if (from < 0) break;    // No legal moves
+            const bool proved_bound = is_maximizing ? (guess >= beta) : (guess < beta);
+            if (proved_bound || best_from < 0) {
+                best_from = from;
+                best_to = to;
             }
+            
+            if (guess < beta) upper = guess;
+            else lower = guess;
+        }
+        
+        if (best_from < 0) break;
+        
+        Dictionary result;
+        result["from"] = best_from;
+        result["to"] = best_to;
+        result["score"] = guess;
+        result["depth"] = current_depth;
+        result["passes"] = passes;
+        best_result = result;
+        
+        if (guess >= MATE_BOUND || guess <= -MATE_BOUND) {
+            break;
         }
     }
     
+    store_search_result(SEARCH_DRIVER_MTDF, max_depth, best_result);
+    end_search_stats();
     return best_result;
 }
 
+// ==================== MATE SEARCH ====================
+
+Dictionary Agent::find_mate(int64_t max_nodes, int max_plies) {
+    Dictionary result;
+    if (!board) return result;
+
+    auto start_time = std::chrono::steady_clock::now();
+    const Position root = *board;
+    MateSearch search;
+    MateSearchResult found = search.search(root, static_cast<uint64_t>(std::max<int64_t>(max_nodes, 1)), max_plies);
+
+    static const char *const status_names[] = {"proven", "disproven", "unproven"};
+
+    Array moves;
+    for (const FastMove &m : found.line) {
+        moves.append(move_to_uci(m));
+    }
+
+    result["status"] = status_names[found.status];
+    result["moves"] = moves;
+    result["mate_in"] = static_cast<int64_t>((found.line.size() + 1) / 2);
+    result["shortest"] = found.shortest;
+    result["nodes"] = static_cast<int64_t>(found.nodes);
+    result["seconds"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
 // ==================== CONSTRUCTOR/DESTRUCTOR ====================
 
 Agent::Agent() : NeuralNet() {
     board = nullptr;
     use_neural_network = false;
+    training_augmentation = AUGMENT_NONE;
+    tt_miss_strategy = TT_MISS_NONE;
     input_features.reserve(NN_TOTAL_INPUTS);
 
+    nodes_searched = 0;
+    search_tt_probes = 0;
+    search_tt_hits = 0;
+    search_start_usec = 0;
+
     init_tt();
     init_mvv_lva_table();
 
@@ -813,7 +1375,10 @@ float Agent::train_on_current_position(uint8_t color, float learning_rate) {
     }
 
     // 1. Extract features from current position
-    extract_features(color);
+    {
+        PhaseTimer timer(training_stats, TRAINING_PHASE_FEATURES);
+        extract_features(color);
+    }
 
     // 2. Get material evaluation as target
     int material_score = evaluate_material();
@@ -827,14 +1392,9 @@ float Agent::train_on_current_position(uint8_t color, float learning_rate) {
     // 3. Convert score to 0.0-1.0 target range
     float target = score_to_target(material_score);
 
-    // 4. Convert input_features to Array for training
-    Array input_array;
-    for (const float& feature : input_features) {
-        input_array.append(feature);
-    }
-
-    // 5. Train on this example
-    float loss = train_single_example(input_array, target, learning_rate);
+    // 4. Train on this example
+    float loss = train_example(input_features, target, learning_rate);
+    EngineMetrics::record_training(1, loss);
 
     return loss;
 }
@@ -853,6 +1413,7 @@ float Agent::train_on_batch(const Array &positions, const Array &targets, float
         return 0.0f;
     }
 
+    TRACE_SCOPE_ARG("train_batch", positions.size());
     float total_loss = 0.0f;
 
     // Train on each position in the batch
@@ -860,12 +1421,146 @@ float Agent::train_on_batch(const Array &positions, const Array &targets, float
         Array position_features = positions[i];
         float target = targets[i];
 
-        float loss = train_single_example(position_features, target, learning_rate);
+        float loss = train_array_example(position_features, target, learning_rate);
         total_loss += loss;
     }
 
     // Return average loss
-    return total_loss / positions.size();
+    float average_loss = total_loss / positions.size();
+    EngineMetrics::record_training(positions.size(), average_loss);
+    return average_loss;
+}
+
+void Agent::set_tt_miss_strategy(int strategy) {
+    if (strategy < TT_MISS_NONE || strategy > TT_MISS_IID) {
+        UtilityFunctions::print("Error: Unknown TT miss strategy: ", strategy);
+        return;
+    }
+    tt_miss_strategy = static_cast<uint8_t>(strategy);
+}
+
+void Agent::set_training_augmentation(int flags) {
+    if (flags < 0 || flags > (AUGMENT_COLOR_FLIP | AUGMENT_FILE_MIRROR)) {
+        UtilityFunctions::print("Error: Invalid augmentation flags ", flags);
+        return;
+    }
+    training_augmentation = static_cast<uint8_t>(flags);
+}
+
+float Agent::train_with_twins(const Position &pos, uint8_t color, float target, float learning_rate, uint64_t &examples) {
+    input_features.resize(NN_TOTAL_INPUTS);
+    const bool mirror_files = (training_augmentation & AUGMENT_FILE_MIRROR) && Features::can_mirror_files(pos);
+
+    // Twins are generated from the same packed position while its features are
+    // expanded, so augmentation costs no storage or I/O
+    float loss = 0.0f;
+    for (uint8_t augmentation = AUGMENT_NONE; augmentation <= (AUGMENT_COLOR_FLIP | AUGMENT_FILE_MIRROR); augmentation++) {
+        if ((augmentation & AUGMENT_COLOR_FLIP) && !(training_augmentation & AUGMENT_COLOR_FLIP)) continue;
+        if ((augmentation & AUGMENT_FILE_MIRROR) && !mirror_files) continue;
+
+        {
+            PhaseTimer timer(training_stats, TRAINING_PHASE_FEATURES);
+            Features::extract(pos, color, input_features.data(), augmentation);
+        }
+        loss += train_example(input_features, Features::augment_target(target, augmentation), learning_rate);
+        examples++;
+    }
+    return loss;
+}
+
+float Agent::train_on_replay_buffer(const Ref<ReplayBuffer> &buffer, int batch_size, float learning_rate) {
+    if (!network_initialized) {
+        UtilityFunctions::print("Error: Network not initialized");
+        return 0.0f;
+    }
+    if (buffer.is_null() || buffer->get_size() == 0 || batch_size <= 0) {
+        return 0.0f;
+    }
+
+    TRACE_SCOPE_ARG("train_replay", batch_size);
+
+    std::vector<uint32_t> slots;
+    {
+        PhaseTimer timer(training_stats, TRAINING_PHASE_DATA_LOADING);
+        buffer->sample_slots(batch_size, slots);
+    }
+
+    float total_loss = 0.0f;
+    uint64_t trained = 0;
+    Position pos;
+
+    for (uint32_t slot : slots) {
+        bool valid;
+        {
+            PhaseTimer timer(training_stats, TRAINING_PHASE_DATA_LOADING);
+            valid = unpack_position(buffer->get_packed(slot), pos);
+        }
+        if (!valid) continue;
+
+        total_loss += train_with_twins(pos, buffer->get_color(slot), buffer->get_target(slot), learning_rate, trained);
+    }
+
+    if (trained == 0) return 0.0f;
+
+    float average_loss = total_loss / trained;
+    EngineMetrics::record_training(trained, average_loss);
+    return average_loss;
+}
+
+float Agent::train_on_dataset(const String &path, float learning_rate, int64_t max_records) {
+    if (!network_initialized) {
+        UtilityFunctions::print("Error: Network not initialized");
+        return -1.0f;
+    }
+
+    CharString native = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+    DatasetReader reader;
+    if (!reader.open(native.get_data())) {
+        UtilityFunctions::print("Error: Cannot open dataset: ", path);
+        return -1.0f;
+    }
+
+    TRACE_SCOPE("train_dataset");
+
+    uint64_t limit = max_records > 0 ? std::min<uint64_t>(max_records, reader.get_count()) : reader.get_count();
+    std::vector<TrainingRecord> batch(4096);
+    double total_loss = 0.0;
+    uint64_t trained = 0;
+    uint64_t consumed = 0;
+    Position pos;
+
+    while (consumed < limit) {
+        size_t n;
+        {
+            PhaseTimer timer(training_stats, TRAINING_PHASE_DATA_LOADING);
+            n = reader.read(batch.data(), static_cast<size_t>(std::min<uint64_t>(batch.size(), limit - consumed)));
+        }
+        if (n == 0) break;
+
+        consumed += n;
+        const uint64_t trained_before = trained;
+        double chunk_loss = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            bool valid;
+            {
+                PhaseTimer timer(training_stats, TRAINING_PHASE_DATA_LOADING);
+                valid = unpack_position(batch[i].position, pos);
+            }
+            if (!valid) continue;
+
+            chunk_loss += train_with_twins(pos, COLOR_WHITE, batch[i].target, learning_rate, trained);
+        }
+
+        // Published once per chunk, so the monitors follow a long run
+        total_loss += chunk_loss;
+        if (trained > trained_before) {
+            EngineMetrics::record_training(trained - trained_before, static_cast<float>(chunk_loss / (trained - trained_before)));
+        }
+    }
+
+    if (trained == 0) return 0.0f;
+
+    return static_cast<float>(total_loss / trained);
 }
 
 // ==================== GODOT BINDINGS ====================
@@ -886,11 +1581,29 @@ void Agent::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_use_neural_network"), &Agent::get_use_neural_network);
 
     // Search methods
-    ClassDB::bind_method(D_METHOD("run_iterative_deepening", "max_depth"), &Agent::run_iterative_deepening);
+    ClassDB::bind_method(D_METHOD("run_iterative_deepening", "max_depth", "time_limit_ms"), &Agent::run_iterative_deepening, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("run_mtdf", "max_depth"), &Agent::run_mtdf);
     ClassDB::bind_method(D_METHOD("get_best_move", "depth"), &Agent::get_best_move);
+    ClassDB::bind_method(D_METHOD("get_nodes_searched"), &Agent::get_nodes_searched);
+    ClassDB::bind_method(D_METHOD("find_mate", "max_nodes", "max_plies"), &Agent::find_mate, DEFVAL(1000000), DEFVAL(MATE_SEARCH_DEFAULT_PLIES));
+
+    // Hash persistence
+    ClassDB::bind_method(D_METHOD("save_hash", "path", "min_depth"), &Agent::save_hash, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("load_hash", "path"), &Agent::load_hash);
+
+    // Persistent result cache
+    ClassDB::bind_method(D_METHOD("open_eval_cache", "path"), &Agent::open_eval_cache);
+    ClassDB::bind_method(D_METHOD("close_eval_cache"), &Agent::close_eval_cache);
+    ClassDB::bind_method(D_METHOD("get_eval_cache_stats"), &Agent::get_eval_cache_stats);
 
     // Training methods
     ClassDB::bind_method(D_METHOD("train_on_current_position", "color", "learning_rate"), &Agent::train_on_current_position);
     ClassDB::bind_method(D_METHOD("train_on_batch", "positions", "targets", "learning_rate"), &Agent::train_on_batch);
+    ClassDB::bind_method(D_METHOD("train_on_replay_buffer", "buffer", "batch_size", "learning_rate"), &Agent::train_on_replay_buffer);
+    ClassDB::bind_method(D_METHOD("train_on_dataset", "path", "learning_rate", "max_records"), &Agent::train_on_dataset, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("set_tt_miss_strategy", "strategy"), &Agent::set_tt_miss_strategy);
+    ClassDB::bind_method(D_METHOD("get_tt_miss_strategy"), &Agent::get_tt_miss_strategy);
+    ClassDB::bind_method(D_METHOD("set_training_augmentation", "flags"), &Agent::set_training_augmentation);
+    ClassDB::bind_method(D_METHOD("get_training_augmentation"), &Agent::get_training_augmentation);
     ClassDB::bind_method(D_METHOD("score_to_target", "material_score"), &Agent::score_to_target);
 }
@@ -3,32 +3,29 @@
 
 #include "neural_network.h"
 #include "board.h"
+#include "eval_cache.h"
+#include "mate_search.h"
+#include "nn_features.h"
+#include "replay_buffer.h"
 #include <godot_cpp/variant/dictionary.hpp>
 #include <cstdint>
+#include <vector>
 
 using namespace godot;
 
-// ==================== NEURAL NETWORK INPUT CONFIGURATION ====================
-
-// Input layer size: 12 piece types × 64 squares + extras
-// Piece planes: P, N, B, R, Q, K (white), p, n, b, r, q, k (black)
-#define NN_PIECE_PLANES     12
-#define NN_SQUARES          64
-#define NN_PIECE_INPUTS     (NN_PIECE_PLANES * NN_SQUARES)  // 768
-
-// Additional inputs
-#define NN_CASTLING_INPUTS  4   // WK, WQ, BK, BQ
-#define NN_TURN_INPUT       1   // Side to move (1.0 = white, 0.0 = black)
-#define NN_EP_INPUTS        8   // En passant file (one-hot, or 0 if none)
-
-// Total input size
-#define NN_TOTAL_INPUTS     (NN_PIECE_INPUTS + NN_CASTLING_INPUTS + NN_TURN_INPUT + NN_EP_INPUTS)  // 781
-
 // ==================== EVALUATION CONSTANTS ====================
 
-#define CHECKMATE_SCORE 100000
+// Mate scores are CHECKMATE_SCORE minus the ply of the mate, counted from the
+// search root (from the node in the TT); anything beyond MATE_BOUND is a mate.
+// Fits TTEntry::score
+#define CHECKMATE_SCORE 32000
+#define MATE_BOUND      (CHECKMATE_SCORE - 1000)
 #define STALEMATE_SCORE 0
 
+// Leaf evaluations of drawish material (Position::is_drawish_material) are
+// divided by this, toward the draw it almost always is
+#define DRAWISH_EVAL_DIVISOR 8
+
 // Piece values for fallback/material evaluation (centipawns)
 #define PAWN_VALUE   100
 #define KNIGHT_VALUE 320
@@ -66,6 +63,42 @@ struct TTEntry {
     uint8_t padding;
 };
 
+// Saved hash file (save_hash/load_hash): TTFileHeader followed by entry_count
+// records of TT_FILE_ENTRY_SIZE bytes (key, score, depth, flag, best_from, best_to)
+// Only occupied slots are written; age is not saved
+#define TT_FILE_MAGIC "CHTT"
+#define TT_FILE_VERSION 2       // 2: mate scores stored relative to the entry's node
+#define TT_FILE_ENTRY_SIZE 14
+
+struct TTFileHeader {
+    char magic[4];          // TT_FILE_MAGIC
+    uint32_t version;       // TT_FILE_VERSION
+    uint32_t entry_size;    // TT_FILE_ENTRY_SIZE
+    uint32_t min_depth;     // Depth threshold used when saving
+    uint64_t key_check;     // Zobrist fingerprint, rejects files from other key sets
+    uint64_t entry_count;
+};
+
+static_assert(sizeof(TTFileHeader) == 32, "TTFileHeader layout changed");
+
+// ==================== TT MISS HANDLING ====================
+
+// What minimax_internal does at a node of depth >= TT_MISS_MIN_DEPTH (not in
+// check) whose TT probe found no best move to try first
+#define TT_MISS_NONE    0   // Search it as is (MVV-LVA, killers, history); the default
+#define TT_MISS_IIR     1   // Internal iterative reduction: one ply shallower
+#define TT_MISS_IID     2   // Internal iterative deepening: search IID_REDUCTION plies shallower first for a TT move
+
+#define TT_MISS_MIN_DEPTH 3
+#define IID_REDUCTION     2
+
+// ==================== SEARCH DRIVERS ====================
+
+// Root search entry points, part of the result cache key
+#define SEARCH_DRIVER_FIXED_DEPTH 0     // get_best_move
+#define SEARCH_DRIVER_ITERATIVE   1     // run_iterative_deepening
+#define SEARCH_DRIVER_MTDF        2     // run_mtdf
+
 // ==================== KILLER MOVES ====================
 
 #define MAX_PLY 64
@@ -80,10 +113,33 @@ struct KillerMove {
     inline bool is_valid() const { return from != 255; }
 };
 
+// ==================== ROOT MOVES ====================
+
+// Time management of run_iterative_deepening (time_limit_ms > 0). Iterations are
+// never interrupted; the checks run between them
+#define ROOT_TIME_NEXT_ITERATION_PERCENT  50   // Past this share of the budget the next depth would not finish
+#define ROOT_TIME_STABLE_PERCENT          20   // Past this share, stop if the best move is settled:
+#define ROOT_STABLE_ITERATIONS            3    //   best for this many iterations in a row
+#define ROOT_STABLE_EFFORT_PERCENT        70   //   and this share of the last iteration's nodes went into it
+
+// A legal root move, kept across iterative deepening iterations. Scores are
+// white-POV like the rest of the search. Moves that did not improve on the
+// best score so far return only a bound from the narrowed root window
+struct RootMove {
+    FastMove move;
+    int score;                  // Last completed iteration
+    bool exact;                 // score is exact, not a bound
+    uint64_t nodes;             // Nodes in this move's subtree in the last iteration
+    std::vector<FastMove> pv;   // Starts with move; followed from the TT for the best move
+};
+
 
 class Agent : public NeuralNet {
     GDCLASS(Agent, NeuralNet)
 
+    // Component benchmarks time the TT and network passes directly (benchmark.cpp)
+    friend class BenchmarkAccess;
+
 private:
     // ==================== BOARD REFERENCE ====================
     Board* board;  // Pointer to the board being analyzed
@@ -94,18 +150,16 @@ private:
     // Input feature vector (populated by extract_features)
     std::vector<float> input_features;
 
+    // AUGMENT_* twins trained alongside each stored position (replay buffer / dataset training)
+    uint8_t training_augmentation;
+
+    // Train on pos and its enabled twins; returns the summed loss, adds to examples
+    float train_with_twins(const Position &pos, uint8_t color, float target, float learning_rate, uint64_t &examples);
+
     // Extract board state into neural network input format
     // If color is COLOR_BLACK (16), mirrors the board horizontally
     void extract_features(uint8_t color);
 
-    // Mirror a square index horizontally (rank 0 ↔ rank 7, etc.)
-    inline uint8_t mirror_square_horizontal(uint8_t square) const {
-        int rank = square / 8;
-        int file = square % 8;
-        int mirrored_rank = 7 - rank;
-        return mirrored_rank * 8 + file;
-    }
-
     // ==================== TRANSPOSITION TABLE ====================
     static TTEntry* tt_table;
     static bool tt_initialized;
@@ -116,6 +170,21 @@ private:
     TTEntry* tt_probe(uint64_t key) const;
     void tt_clear();
     void tt_new_search();
+    static uint64_t tt_key_check();
+    
+    // ==================== PERSISTENT RESULT CACHE ====================
+    // Shared by all agents; null until open_eval_cache() succeeds
+    static EvalCache* eval_cache;
+
+    // Identity of the active evaluator (model checksum, 0 = material)
+    uint32_t evaluator_checksum();
+
+    // Root search results are cached per driver (SEARCH_DRIVER_*) and TT miss
+    // strategy, with the PV where the driver has one. A hit resets the search
+    // stats (nodes_searched 0)
+    int search_variant(int driver) const { return driver * (TT_MISS_IID + 1) + tt_miss_strategy; }
+    bool lookup_search_result(int driver, int depth, Dictionary &result);
+    void store_search_result(int driver, int depth, const Dictionary &result, const std::vector<FastMove> *pv = nullptr);
     
     // ==================== KILLER MOVES ====================
     KillerMove killer_moves[MAX_PLY][2];
@@ -145,6 +214,38 @@ private:
     // ==================== SEARCH ALGORITHMS ====================
     int minimax_internal(int depth, int ply, int alpha, int beta, bool is_maximizing);
 
+    // TT_MISS_* strategy for nodes without a TT move
+    uint8_t tt_miss_strategy;
+
+    // One root search within (alpha, beta), fail-soft; best move of the pass in best_from/best_to
+    int search_root(int depth, int alpha, int beta, int &best_from, int &best_to);
+
+    // ==================== ROOT MOVES ====================
+    // Persist across the iterations of run_iterative_deepening, best first
+    std::vector<RootMove> root_moves;
+
+    // Legal moves of the current position in TT / MVV-LVA order, unscored
+    void init_root_moves();
+
+    // Moves best_index to the front: it set the iteration's exact best score, which
+    // a refuted move's bound can equal. The rest follow with exact scores before
+    // bounds, each best score first, then the most searched
+    void sort_root_moves(bool is_maximizing, int best_index);
+
+    // Refill root_move.pv: its move, then TT best moves while they are legal (at most max_length in all)
+    void extract_pv(RootMove &root_move, int max_length);
+
+    // ==================== SEARCH STATISTICS ====================
+    // Counted per search and published to EngineMetrics when the search completes
+    uint64_t nodes_searched;
+    uint64_t search_tt_probes;
+    uint64_t search_tt_hits;
+    uint64_t search_start_usec;
+
+    void begin_search_stats();
+    void end_search_stats();
+    static uint32_t tt_fill_permille();
+
 protected:
     static void _bind_methods();
 
@@ -178,9 +279,57 @@ public:
     bool get_use_neural_network() const { return use_neural_network; }
 
     // ==================== SEARCH INTERFACE ====================
-    Dictionary run_iterative_deepening(int max_depth);
+    // Searches depth 1..max_depth; root moves are reordered between iterations by
+    // score and then subtree effort. With time_limit_ms > 0 the search stops between
+    // iterations once the budget is spent, the next depth would not fit in it, or the
+    // best move has been stable and took most of the nodes (ROOT_* above)
+    // {from, to, score, depth, pv: [UCI]}
+    Dictionary run_iterative_deepening(int max_depth, int64_t time_limit_ms = 0);
     Dictionary get_best_move(int depth);
 
+    // Iterative deepening where each depth is found with MTD(f): zero-window
+    // root searches converging on the value, seeded by the previous depth and
+    // leaning on the TT for the re-searches. Same result keys as
+    // run_iterative_deepening, plus the total number of zero-window passes
+    // {from, to, score, depth, passes}
+    Dictionary run_mtdf(int max_depth);
+
+    // Handling of deep nodes without a TT move, for comparing search trees:
+    // TT_MISS_NONE (0, default), TT_MISS_IIR (1) or TT_MISS_IID (2). Opt-in:
+    // IIR makes a fixed-depth get_best_move on a fresh TT search shallower
+    void set_tt_miss_strategy(int strategy);
+    int get_tt_miss_strategy() const { return tt_miss_strategy; }
+
+    // Nodes visited by the most recent search
+    int64_t get_nodes_searched() const { return static_cast<int64_t>(nodes_searched); }
+
+    // Proof-number search for a forced mate by the side to move (mate_search.h),
+    // independent of the TT and the evaluation. Gives up after max_nodes expansions
+    // in total (rebuilding the line included) or on lines longer than max_plies. After a proof the node budget goes into
+    // shorter mates; shortest is true once none exists. moves is the mating line with
+    // the longest defence, mate_in its length in moves (moves empty and mate_in 0 if
+    // the line could not be rebuilt)
+    // Returns {status: "proven" | "disproven" | "unproven", moves: [UCI], mate_in, shortest, nodes, seconds}
+    Dictionary find_mate(int64_t max_nodes = 1000000, int max_plies = MATE_SEARCH_DEFAULT_PLIES);
+
+    // ==================== HASH PERSISTENCE ====================
+    // Write the live transposition table entries with depth >= min_depth
+    bool save_hash(const String &path, int min_depth = 0);
+
+    // Merge a saved table into the live one (memory-mapped, deeper entries win)
+    // Returns the number of entries stored, or -1 if the file is invalid
+    int64_t load_hash(const String &path);
+
+    // ==================== PERSISTENT RESULT CACHE ====================
+    // Opens (or creates) an on-disk cache of network evaluations and root search
+    // results keyed by position hash, model checksum and depth. Repeated work
+    // across runs (labelling, analysis of common openings) becomes a lookup
+    bool open_eval_cache(const String &path);
+    void close_eval_cache();
+
+    // {open, entries, hits, misses}
+    Dictionary get_eval_cache_stats() const;
+
     // ==================== TRAINING INTERFACE ====================
     // Train on the current board position using material evaluation as target
     // This trains the neural network to match the material evaluation function
@@ -196,6 +345,23 @@ public:
     // Returns average loss across the batch
     float train_on_batch(const Array &positions, const Array &targets, float learning_rate);
 
+    // Train on batch_size entries sampled from a replay buffer (uniform or by priority)
+    // Features are extracted straight from the packed positions into the input vector
+    // Returns average loss across the batch
+    float train_on_replay_buffer(const Ref<ReplayBuffer> &buffer, int batch_size, float learning_rate);
+
+    // One sequential pass over a binary dataset (ideally shuffled with
+    // DatasetTools.shuffle_dataset), training on each record's target from
+    // white's perspective. max_records = 0 reads the whole file
+    // Returns average loss, or -1.0 if the file can't be read
+    float train_on_dataset(const String &path, float learning_rate, int64_t max_records = 0);
+
+    // Symmetry augmentation for train_on_replay_buffer / train_on_dataset
+    // flags: AUGMENT_COLOR_FLIP (1) adds the colour-flipped twin with target 1 - t,
+    //        AUGMENT_FILE_MIRROR (2) adds the a↔h mirrored twin of positions without castling rights
+    void set_training_augmentation(int flags);
+    int get_training_augmentation() const { return training_augmentation; }
+
     // Convert material evaluation score to a 0.0-1.0 target for neural network training
     // Positive scores (good for current color) → values closer to 1.0
     // Negative scores (bad for current color) → values closer to 0.0
@@ -0,0 +1,348 @@
+#include "benchmark.h"
+#include "agent.h"
+#include "nn_features.h"
+#include "position.h"
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace godot;
+
+void Benchmark::_bind_methods() {
+    ClassDB::bind_static_method("Benchmark", D_METHOD("run", "filter", "min_seconds"), &Benchmark::run, DEFVAL(""), DEFVAL(0.25));
+}
+
+// ==================== FIXED INPUTS ====================
+
+struct BenchmarkPosition {
+    const char *name;
+    const char *fen;
+};
+
+static const BenchmarkPosition BENCHMARK_POSITIONS[] = {
+    {"opening",    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3"},
+    {"middlegame", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+    {"endgame",    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"},
+    {"check",      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"},
+};
+
+// Network shape used by the NN benchmarks (board features -> 256 -> 32 -> 1)
+static const int BENCHMARK_HIDDEN_1 = 256;
+static const int BENCHMARK_HIDDEN_2 = 32;
+static const int BENCHMARK_BATCH = 64;     // Rows per forward_batch_64 op
+static const int BENCHMARK_SEARCH_DEPTH = 4;
+static const int BENCHMARK_TT_MISS_DEPTH = 5;   // Deep enough for nodes at TT_MISS_MIN_DEPTH below the root
+
+// Results are folded in here so the compiler can't drop the measured work
+static volatile uint64_t benchmark_sink = 0;
+
+// ==================== HARNESS ====================
+
+class BenchmarkRunner {
+private:
+    std::string filter;
+    double min_seconds;
+
+public:
+    Array results;
+
+    BenchmarkRunner(const std::string &p_filter, double p_min_seconds) : filter(p_filter), min_seconds(p_min_seconds) {}
+
+    bool wants(const std::string &name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    // body(n) performs n operations and returns a value depending on their results.
+    // Batches double in size until min_seconds of work has been timed.
+    // Returns the result entry (empty if filtered out) for extra keys
+    template <typename Body>
+    Dictionary measure(const std::string &name, Body body) {
+        if (!wants(name)) return Dictionary();
+
+        uint64_t ops = 0;
+        double seconds = 0.0;
+        uint64_t batch = 1;
+        while (seconds < min_seconds) {
+            auto start = std::chrono::steady_clock::now();
+            benchmark_sink = benchmark_sink + body(batch);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ops += batch;
+            if (batch < (uint64_t(1) << 24)) batch *= 2;
+        }
+
+        Dictionary result;
+        result["name"] = String(name.c_str());
+        result["ns_per_op"] = seconds * 1e9 / ops;
+        result["ops"] = static_cast<int64_t>(ops);
+        results.append(result);
+        return result;
+    }
+};
+
+// ==================== BENCHMARKS ====================
+
+static void benchmark_position(BenchmarkRunner &runner, const BenchmarkPosition &fixed) {
+    Position pos;
+    if (!pos.parse_fen(fixed.fen)) {
+        UtilityFunctions::print("Error: Benchmark position does not parse: ", fixed.fen);
+        return;
+    }
+
+    runner.measure(std::string("movegen_pseudo_") + fixed.name, [&](uint64_t n) {
+        MoveList moves;
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            pos.generate_all_pseudo_legal(moves);
+            total += moves.count;
+        }
+        return total;
+    });
+
+    runner.measure(std::string("movegen_legal_") + fixed.name, [&](uint64_t n) {
+        MoveList moves;
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            pos.generate_legal_moves(moves);
+            total += moves.count;
+        }
+        return total;
+    });
+}
+
+static void benchmark_board(BenchmarkRunner &runner) {
+    Position pos;
+    pos.parse_fen(BENCHMARK_POSITIONS[1].fen);
+    MoveList moves;
+    pos.generate_all_pseudo_legal(moves);
+
+    // One op = make_move_fast + unmake_move_fast of one pseudo-legal move
+    runner.measure("make_unmake", [&](uint64_t n) {
+        const uint8_t ep_before = pos.get_en_passant_target();
+        const uint8_t castling_before = pos.get_castling_rights();
+        const uint64_t hash_before = pos.get_hash();
+
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            const FastMove &m = moves.moves[i % moves.count];
+            pos.make_move_fast(m);
+            total += pos.get_hash();
+            pos.unmake_move_fast(m, ep_before, castling_before, hash_before);
+        }
+        return total;
+    });
+
+    // One op = one pseudo-legal move applied to a copy of the position
+    runner.measure("copy_make", [&](uint64_t n) {
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            total += pos.after(moves.moves[i % moves.count]).get_hash();
+        }
+        return total;
+    });
+
+    // One op = a depth-3 perft of the middlegame position (97862 nodes),
+    // comparing the two ways of walking a tree
+    runner.measure("perft3_make_unmake", [&](uint64_t n) {
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) total += pos.count_all_moves(3);
+        return total;
+    });
+    runner.measure("perft3_copy_make", [&](uint64_t n) {
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) total += pos.count_all_moves_copy(3);
+        return total;
+    });
+
+    // One op = one square / attacker colour query, cycling over all of them
+    runner.measure("square_attacked", [&](uint64_t n) {
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            total += pos.is_square_attacked_fast(static_cast<uint8_t>(i & 63), static_cast<uint8_t>((i >> 6) & 1));
+        }
+        return total;
+    });
+
+    runner.measure("extract_features", [&](uint64_t n) {
+        std::vector<float> features(NN_TOTAL_INPUTS);
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            Features::extract(pos, static_cast<uint8_t>(i & 1), features.data());
+            total += features[NN_PIECE_INPUTS];
+        }
+        return total;
+    });
+}
+
+// Friend of Agent: reaches the forward / backward passes and the TT directly
+class BenchmarkAccess {
+public:
+    static void run_network(BenchmarkRunner &runner, Agent *agent) {
+        if (!runner.wants("forward_dense") && !runner.wants("forward_batch_64") && !runner.wants("backpropagate")) return;
+
+        Array shape;
+        shape.append(NN_TOTAL_INPUTS);
+        shape.append(BENCHMARK_HIDDEN_1);
+        shape.append(BENCHMARK_HIDDEN_2);
+        shape.append(1);
+        agent->initialize_neural_network(shape, "relu");
+
+        // Features of the fixed positions, cycled through
+        std::vector<std::vector<float>> inputs;
+        for (const BenchmarkPosition &fixed : BENCHMARK_POSITIONS) {
+            Position pos;
+            pos.parse_fen(fixed.fen);
+            inputs.emplace_back(NN_TOTAL_INPUTS);
+            Features::extract(pos, COLOR_WHITE, inputs.back().data());
+        }
+        const size_t input_count = inputs.size();
+
+        runner.measure("forward_dense", [&](uint64_t n) {
+            float total = 0.0f;
+            for (uint64_t i = 0; i < n; i++) {
+                total += agent->forward_pass(inputs[i % input_count]);
+            }
+            return static_cast<uint64_t>(total);
+        });
+
+        // One op = one forward_batch call over BENCHMARK_BATCH positions
+        std::vector<float> batch(static_cast<size_t>(BENCHMARK_BATCH) * NN_TOTAL_INPUTS);
+        for (int row = 0; row < BENCHMARK_BATCH; row++) {
+            std::copy(inputs[row % input_count].begin(), inputs[row % input_count].end(),
+                      batch.begin() + static_cast<size_t>(row) * NN_TOTAL_INPUTS);
+        }
+        runner.measure("forward_batch_64", [&](uint64_t n) {
+            std::vector<float> scratch;
+            std::vector<float> outputs(BENCHMARK_BATCH);
+            float total = 0.0f;
+            for (uint64_t i = 0; i < n; i++) {
+                agent->forward_batch(batch.data(), BENCHMARK_BATCH, scratch, outputs.data());
+                total += outputs[0];
+            }
+            return static_cast<uint64_t>(total);
+        });
+
+        // Activations from one forward pass, gradients accumulate
+        agent->forward_pass(inputs[0]);
+        runner.measure("backpropagate", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                agent->backpropagate(0.75f);
+            }
+            return static_cast<uint64_t>(agent->bias_gradients[0][0] != 0.0f);
+        });
+    }
+
+    static void run_tt(BenchmarkRunner &runner, Agent *agent) {
+        if (!runner.wants("tt_store") && !runner.wants("tt_probe")) return;
+
+        std::mt19937_64 rng(0xBE7C4);
+        std::vector<uint64_t> keys(1 << 16);
+        for (uint64_t &key : keys) key = rng();
+        const size_t mask = keys.size() - 1;
+
+        runner.measure("tt_store", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                agent->tt_store(keys[i & mask], static_cast<int>(i & 1023), static_cast<int>(i & 7), TT_FLAG_EXACT, 12, 28);
+            }
+            return n;
+        });
+
+        runner.measure("tt_probe", [&](uint64_t n) {
+            uint64_t hits = 0;
+            for (uint64_t i = 0; i < n; i++) {
+                hits += agent->tt_probe(keys[i & mask]) != nullptr;
+            }
+            return hits;
+        });
+
+        agent->tt_clear();
+    }
+
+    // One op = a fresh-TT search of one fixed position to BENCHMARK_SEARCH_DEPTH
+    // (material evaluation). Every driver runs on every BENCHMARK_POSITIONS entry
+    // as <benchmark>_<position>; nodes_per_op compares the strategies' tree sizes
+    static void run_search(BenchmarkRunner &runner, Agent *agent) {
+        // Deep nodes without a TT move: plain ordering vs reduction vs a shallow search first
+        static const char *const tt_miss_names[] = {"search_tt_miss_none_", "search_tt_miss_iir_", "search_tt_miss_iid_"};
+        static const char *const driver_names[] = {"search_iterative_deepening_", "search_mtdf_"};
+        bool wanted = false;
+        for (const BenchmarkPosition &fixed : BENCHMARK_POSITIONS) {
+            for (const char *name : driver_names) wanted = wanted || runner.wants(name + std::string(fixed.name));
+            for (const char *name : tt_miss_names) wanted = wanted || runner.wants(name + std::string(fixed.name));
+        }
+        if (!wanted) return;
+
+        Board *board = memnew(Board);
+        agent->set_board(board);
+        const bool use_nn = agent->get_use_neural_network();
+        agent->set_use_neural_network(false);
+
+        // Every op must search: no answers from an open result cache
+        EvalCache *eval_cache = Agent::eval_cache;
+        Agent::eval_cache = nullptr;
+
+        auto search = [&](const std::string &name, auto driver) {
+            uint64_t nodes = 0;
+            uint64_t searches = 0;
+            Dictionary result = runner.measure(name, [&](uint64_t n) {
+                uint64_t total = 0;
+                for (uint64_t i = 0; i < n; i++) {
+                    agent->tt_clear();
+                    Dictionary found = driver(BENCHMARK_SEARCH_DEPTH);
+                    total += static_cast<int64_t>(found.get("score", 0));
+                    nodes += agent->nodes_searched;
+                    searches++;
+                }
+                return total;
+            });
+            if (searches > 0 && !result.is_empty()) {
+                result["nodes_per_op"] = static_cast<int64_t>(nodes / searches);
+            }
+        };
+
+        const int tt_miss_strategy = agent->get_tt_miss_strategy();
+
+        for (const BenchmarkPosition &fixed : BENCHMARK_POSITIONS) {
+            board->setup_board(fixed.fen);
+
+            agent->set_tt_miss_strategy(tt_miss_strategy);
+            search(driver_names[0] + std::string(fixed.name), [&](int depth) { return agent->run_iterative_deepening(depth); });
+            search(driver_names[1] + std::string(fixed.name), [&](int depth) { return agent->run_mtdf(depth); });
+
+            for (int strategy = TT_MISS_NONE; strategy <= TT_MISS_IID; strategy++) {
+                agent->set_tt_miss_strategy(strategy);
+                search(tt_miss_names[strategy] + std::string(fixed.name), [&](int) { return agent->run_iterative_deepening(BENCHMARK_TT_MISS_DEPTH); });
+            }
+        }
+        agent->set_tt_miss_strategy(tt_miss_strategy);
+
+        agent->tt_clear();
+        Agent::eval_cache = eval_cache;
+        agent->set_use_neural_network(use_nn);
+        agent->set_board(nullptr);
+        memdelete(board);
+    }
+};
+
+Dictionary Benchmark::run(const String &filter, double min_seconds) {
+    BenchmarkRunner runner(filter.utf8().get_data(), std::max(min_seconds, 0.001));
+
+    for (const BenchmarkPosition &fixed : BENCHMARK_POSITIONS) {
+        benchmark_position(runner, fixed);
+    }
+    benchmark_board(runner);
+
+    Agent *agent = memnew(Agent);
+    BenchmarkAccess::run_network(runner, agent);
+    BenchmarkAccess::run_tt(runner, agent);
+    BenchmarkAccess::run_search(runner, agent);
+    memdelete(agent);
+
+    Dictionary report;
+    report["min_seconds"] = min_seconds;
+    report["results"] = runner.results;
+    return report;
+}
@@ -0,0 +1,39 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+using namespace godot;
+
+// ==================== COMPONENT BENCHMARKS ====================
+
+// Times the engine's hot components in isolation on fixed inputs and reports
+// ns/op, so a regression can be attributed to one component instead of a
+// perft total or a whole game. Run headless with tools/benchmark.gd, which
+// writes the result as JSON for comparing builds:
+//   godot --headless --path C.H.E.S.S --script res://tools/benchmark.gd -- --out=user://bench.json
+//
+// Benchmarks: movegen_pseudo_* / movegen_legal_* (opening, middlegame, endgame,
+// check), make_unmake, copy_make, perft3_make_unmake, perft3_copy_make,
+// square_attacked, extract_features, forward_dense, forward_batch_64
+// (64 positions per op), backpropagate, tt_store, tt_probe,
+// search_iterative_deepening_*, search_mtdf_* (depth 4) and
+// search_tt_miss_none_* / _iir_* / _iid_* (depth 5, per TT_MISS_* strategy),
+// each per fixed position and with nodes_per_op.
+// The TT and search benchmarks use the shared transposition table and clear it afterwards.
+class Benchmark : public RefCounted {
+    GDCLASS(Benchmark, RefCounted)
+
+protected:
+    static void _bind_methods();
+
+public:
+    // Runs every benchmark whose name contains `filter` (empty = all), each for
+    // at least min_seconds. Returns {min_seconds, results: [{name, ns_per_op, ops}]}
+    static Dictionary run(const String &filter, double min_seconds);
+};
+
+#endif // BENCHMARK_H
@@ -1,852 +1,75 @@
 #include "board.h"
-#include "zobrist.h"
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
 
 using namespace godot;
 
-// ==================== STATIC MEMBER DEFINITIONS ====================
-
-bool Board::tables_initialized = false;
-uint8_t Board::knight_attack_squares[64][8];
-uint8_t Board::knight_attack_count[64];
-uint8_t Board::king_attack_squares[64][8];
-uint8_t Board::king_attack_count[64];
-uint8_t Board::squares_to_edge[64][8];
-
-// Knight move offsets: {file_delta, rank_delta}
-static const int KNIGHT_DELTAS[8][2] = {
-    {1, 2}, {2, 1}, {2, -1}, {1, -2},
-    {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}
-};
-
-// King move offsets
-static const int KING_DELTAS[8][2] = {
-    {0, 1}, {0, -1}, {1, 0}, {-1, 0},
-    {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
-};
-
-// Direction offsets (N, S, E, W, NE, NW, SE, SW)
-static const int DIR_OFFSETS[8] = {8, -8, 1, -1, 9, 7, -7, -9};
-
-// ==================== STATIC INITIALIZATION ====================
-
-void Board::init_attack_tables() {
-    if (tables_initialized) return;
-    
-    for (int sq = 0; sq < 64; sq++) {
-        int file = sq % 8;
-        int rank = sq / 8;
-        
-        // Knight attacks
-        knight_attack_count[sq] = 0;
-        for (int i = 0; i < 8; i++) {
-            int new_file = file + KNIGHT_DELTAS[i][0];
-            int new_rank = rank + KNIGHT_DELTAS[i][1];
-            if (new_file >= 0 && new_file < 8 && new_rank >= 0 && new_rank < 8) {
-                knight_attack_squares[sq][knight_attack_count[sq]++] = new_rank * 8 + new_file;
-            }
-        }
-        
-        // King attacks
-        king_attack_count[sq] = 0;
-        for (int i = 0; i < 8; i++) {
-            int new_file = file + KING_DELTAS[i][0];
-            int new_rank = rank + KING_DELTAS[i][1];
-            if (new_file >= 0 && new_file < 8 && new_rank >= 0 && new_rank < 8) {
-                king_attack_squares[sq][king_attack_count[sq]++] = new_rank * 8 + new_file;
-            }
-        }
-        
-        // Squares to edge
-        squares_to_edge[sq][0] = 7 - rank;
-        squares_to_edge[sq][1] = rank;
-        squares_to_edge[sq][2] = 7 - file;
-        squares_to_edge[sq][3] = file;
-        squares_to_edge[sq][4] = (7 - rank < 7 - file) ? 7 - rank : 7 - file;
-        squares_to_edge[sq][5] = (7 - rank < file) ? 7 - rank : file;
-        squares_to_edge[sq][6] = (rank < 7 - file) ? rank : 7 - file;
-        squares_to_edge[sq][7] = (rank < file) ? rank : file;
-    }
-    
-    tables_initialized = true;
-}
-
-// ==================== ZOBRIST HASHING ====================
-
-int Board::get_zobrist_piece_index(uint8_t piece) const {
-    if (IS_EMPTY(piece)) return -1;
-    
-    uint8_t type = GET_PIECE_TYPE(piece);
-    bool is_white = IS_WHITE(piece);
-    
-    return (type - 1) + (is_white ? 0 : 6);
-}
-
-void Board::hash_piece(uint8_t piece, uint8_t square) {
-    int piece_index = get_zobrist_piece_index(piece);
-    if (piece_index >= 0 && square < 64) {
-        current_hash ^= Zobrist::piece_keys[piece_index][square];
-    }
-}
-
-void Board::hash_castling(int right) {
-    if (right >= 0 && right < 4) {
-        current_hash ^= Zobrist::castling_keys[right];
-    }
-}
-
-void Board::hash_en_passant(uint8_t ep_square) {
-    if (ep_square < 64) {
-        int file = ep_square % 8;
-        current_hash ^= Zobrist::en_passant_keys[file];
-    }
-}
-
-void Board::hash_side() {
-    current_hash ^= Zobrist::side_key;
-}
-
-uint64_t Board::calculate_hash() const {
-    uint64_t hash = 0;
-    
-    for (int sq = 0; sq < 64; sq++) {
-        uint8_t piece = squares[sq];
-        if (!IS_EMPTY(piece)) {
-            int piece_index = get_zobrist_piece_index(piece);
-            if (piece_index >= 0) {
-                hash ^= Zobrist::piece_keys[piece_index][sq];
-            }
-        }
-    }
-    
-    for (int i = 0; i < 4; i++) {
-        if (castling_rights[i]) {
-            hash ^= Zobrist::castling_keys[i];
-        }
-    }
-    
-    if (en_passant_target < 64) {
-        int file = en_passant_target % 8;
-        hash ^= Zobrist::en_passant_keys[file];
-    }
-    
-    if (turn == 1) {
-        hash ^= Zobrist::side_key;
-    }
-    
-    return hash;
-}
-
-// ==================== CONSTRUCTOR/DESTRUCTOR ====================
-
-Board::Board() {
-    Zobrist::init();
-    init_attack_tables();
-    
-    clear_board();
-    turn = 0;
-    en_passant_target = 255;
-    halfmove_clock = 0;
-    fullmove_number = 1;
-    promotion_pending = false;
-    promotion_pending_from = 0;
-    promotion_pending_to = 0;
-    white_king_pos = 4;
-    black_king_pos = 60;
-    current_hash = 0;
-    
-    for (int i = 0; i < 4; i++) {
-        castling_rights[i] = true;
-    }
-}
-
-Board::~Board() {
-}
-
-void Board::_ready() {
-    initialize_starting_position();
-}
-
-void Board::_bind_methods() {
-    ClassDB::bind_method(D_METHOD("get_turn"), &Board::get_turn);
-    ClassDB::bind_method(D_METHOD("get_piece_on_square", "pos"), &Board::get_piece_on_square);
-    ClassDB::bind_method(D_METHOD("set_piece_on_square", "pos", "piece"), &Board::set_piece_on_square);
-    ClassDB::bind_method(D_METHOD("setup_board", "fen_notation"), &Board::setup_board);
-    ClassDB::bind_method(D_METHOD("get_fen"), &Board::get_fen);
-    ClassDB::bind_method(D_METHOD("attempt_move", "start", "end"), &Board::attempt_move);
-    ClassDB::bind_method(D_METHOD("commit_promotion", "type_str"), &Board::commit_promotion);
-    ClassDB::bind_method(D_METHOD("revert_move"), &Board::revert_move);
-    ClassDB::bind_method(D_METHOD("get_moves"), &Board::get_moves);
-    ClassDB::bind_method(D_METHOD("get_all_possible_moves", "color"), &Board::get_all_possible_moves);
-    ClassDB::bind_method(D_METHOD("get_legal_moves_for_piece", "square"), &Board::get_legal_moves_for_piece);
-    ClassDB::bind_method(D_METHOD("get_perft_analysis", "depth"), &Board::get_perft_analysis);
-    ClassDB::bind_method(D_METHOD("make_move", "start", "end"), &Board::make_move);
-    ClassDB::bind_method(D_METHOD("is_checkmate", "color"), &Board::is_checkmate);
-    ClassDB::bind_method(D_METHOD("is_stalemate", "color"), &Board::is_stalemate);
-    ClassDB::bind_method(D_METHOD("is_check", "color"), &Board::is_check);
-    ClassDB::bind_method(D_METHOD("is_game_over"), &Board::is_game_over);
-    ClassDB::bind_method(D_METHOD("get_game_result"), &Board::get_game_result);
-    ClassDB::bind_method(D_METHOD("pos_to_coords", "pos"), &Board::pos_to_coords);
-    ClassDB::bind_method(D_METHOD("coords_to_pos", "rank", "file"), &Board::coords_to_pos);
-    ClassDB::bind_method(D_METHOD("square_to_algebraic", "pos"), &Board::square_to_algebraic);
-    ClassDB::bind_method(D_METHOD("algebraic_to_square", "algebraic"), &Board::algebraic_to_square);
-}
-
-// ==================== BOARD SETUP ====================
-
-void Board::clear_board() {
-    memset(squares, 0, sizeof(squares));
-    move_history.clear();
-    move_history_notation.clear();
-    white_king_pos = 255;
-    black_king_pos = 255;
-    white_piece_count = 0;
-    black_piece_count = 0;
-    current_hash = 0;
-}
-
-void Board::rebuild_piece_lists() {
-    white_piece_count = 0;
-    black_piece_count = 0;
-
-    for (uint8_t sq = 0; sq < 64; sq++) {
-        uint8_t piece = squares[sq];
-        if (!IS_EMPTY(piece)) {
-            add_piece_to_list(sq, piece);
-        }
-    }
-}
-
-void Board::update_king_cache() {
-    white_king_pos = 255;
-    black_king_pos = 255;
-    for (int i = 0; i < 64; i++) {
-        if (GET_PIECE_TYPE(squares[i]) == PIECE_KING) {
-            if (IS_WHITE(squares[i])) white_king_pos = i;
-            else black_king_pos = i;
-        }
-    }
-}
-
-void Board::initialize_starting_position() {
-    clear_board();
-    
-    squares[0] = MAKE_PIECE(PIECE_ROOK, COLOR_WHITE);
-    squares[1] = MAKE_PIECE(PIECE_KNIGHT, COLOR_WHITE);
-    squares[2] = MAKE_PIECE(PIECE_BISHOP, COLOR_WHITE);
-    squares[3] = MAKE_PIECE(PIECE_QUEEN, COLOR_WHITE);
-    squares[4] = MAKE_PIECE(PIECE_KING, COLOR_WHITE);
-    squares[5] = MAKE_PIECE(PIECE_BISHOP, COLOR_WHITE);
-    squares[6] = MAKE_PIECE(PIECE_KNIGHT, COLOR_WHITE);
-    squares[7] = MAKE_PIECE(PIECE_ROOK, COLOR_WHITE);
-    
-    for (int i = 8; i < 16; i++) {
-        squares[i] = MAKE_PIECE(PIECE_PAWN, COLOR_WHITE);
-    }
-    
-    for (int i = 48; i < 56; i++) {
-        squares[i] = MAKE_PIECE(PIECE_PAWN, COLOR_BLACK);
-    }
-    
-    squares[56] = MAKE_PIECE(PIECE_ROOK, COLOR_BLACK);
-    squares[57] = MAKE_PIECE(PIECE_KNIGHT, COLOR_BLACK);
-    squares[58] = MAKE_PIECE(PIECE_BISHOP, COLOR_BLACK);
-    squares[59] = MAKE_PIECE(PIECE_QUEEN, COLOR_BLACK);
-    squares[60] = MAKE_PIECE(PIECE_KING, COLOR_BLACK);
-    squares[61] = MAKE_PIECE(PIECE_BISHOP, COLOR_BLACK);
-    squares[62] = MAKE_PIECE(PIECE_KNIGHT, COLOR_BLACK);
-    squares[63] = MAKE_PIECE(PIECE_ROOK, COLOR_BLACK);
-    
-    turn = 0;
-    for (int i = 0; i < 4; i++) castling_rights[i] = true;
-    en_passant_target = 255;
-    halfmove_clock = 0;
-    fullmove_number = 1;
-    promotion_pending = false;
-    white_king_pos = 4;
-    black_king_pos = 60;
-
-    rebuild_piece_lists();
-    current_hash = calculate_hash();
-}
-
-bool Board::parse_fen(const String &fen) {
-    clear_board();
-    
-    PackedStringArray parts = fen.split(" ");
-    if (parts.size() < 1) return false;
-    
-    String placement = parts[0];
-    int square = 56;
-    
-    for (int i = 0; i < placement.length(); i++) {
-        char32_t c = placement[i];
-        
-        if (c == '/') {
-            square -= 16;
-            continue;
-        }
-        
-        if (c >= '1' && c <= '8') {
-            square += (c - '0');
-            continue;
-        }
-        
-        uint8_t piece = PIECE_NONE;
-        uint8_t color = (c >= 'A' && c <= 'Z') ? COLOR_WHITE : COLOR_BLACK;
-        
-        char32_t lower_c = (c >= 'A' && c <= 'Z') ? (c + 32) : c;
-        
-        switch (lower_c) {
-            case 'p': piece = PIECE_PAWN; break;
-            case 'n': piece = PIECE_KNIGHT; break;
-            case 'b': piece = PIECE_BISHOP; break;
-            case 'r': piece = PIECE_ROOK; break;
-            case 'q': piece = PIECE_QUEEN; break;
-            case 'k': piece = PIECE_KING; break;
-            default: return false;
-        }
-        
-        if (square >= 0 && square < 64) {
-            squares[square] = MAKE_PIECE(piece, color);
-        }
-        square++;
-    }
-    
-    if (parts.size() >= 2) {
-        turn = (parts[1] == "b") ? 1 : 0;
-    }
-    
-    castling_rights[0] = false;
-    castling_rights[1] = false;
-    castling_rights[2] = false;
-    castling_rights[3] = false;
-    
-    if (parts.size() >= 3 && parts[2] != "-") {
-        String castling = parts[2];
-        for (int i = 0; i < castling.length(); i++) {
-            char32_t c = castling[i];
-            if (c == 'K') castling_rights[0] = true;
-            if (c == 'Q') castling_rights[1] = true;
-            if (c == 'k') castling_rights[2] = true;
-            if (c == 'q') castling_rights[3] = true;
-        }
-    }
-    
-    en_passant_target = 255;
-    if (parts.size() >= 4 && parts[3] != "-") {
-        en_passant_target = algebraic_to_square(parts[3]);
-    }
-    
-    halfmove_clock = 0;
-    if (parts.size() >= 5) {
-        halfmove_clock = parts[4].to_int();
-    }
-    
-    fullmove_number = 1;
-    if (parts.size() >= 6) {
-        fullmove_number = parts[5].to_int();
-    }
-    
-    update_king_cache();
-    rebuild_piece_lists();
-    current_hash = calculate_hash();
-    
-    return true;
-}
-
-String Board::generate_fen() const {
-    String fen = "";
-    
-    for (int rank = 7; rank >= 0; rank--) {
-        int empty_count = 0;
-        
-        for (int file = 0; file < 8; file++) {
-            int sq = rank * 8 + file;
-            uint8_t piece = squares[sq];
-            
-            if (IS_EMPTY(piece)) {
-                empty_count++;
-            } else {
-                if (empty_count > 0) {
-                    fen += String::num_int64(empty_count);
-                    empty_count = 0;
-                }
-                
-                char piece_char = '.';
-                switch (GET_PIECE_TYPE(piece)) {
-                    case PIECE_PAWN:   piece_char = 'p'; break;
-                    case PIECE_KNIGHT: piece_char = 'n'; break;
-                    case PIECE_BISHOP: piece_char = 'b'; break;
-                    case PIECE_ROOK:   piece_char = 'r'; break;
-                    case PIECE_QUEEN:  piece_char = 'q'; break;
-                    case PIECE_KING:   piece_char = 'k'; break;
-                }
-                
-                if (IS_WHITE(piece)) piece_char -= 32;
-                fen += String::chr(piece_char);
-            }
-        }
-        
-        if (empty_count > 0) fen += String::num_int64(empty_count);
-        if (rank > 0) fen += "/";
-    }
-    
-    fen += (turn == 0) ? " w " : " b ";
-    
-    String castling = "";
-    if (castling_rights[0]) castling += "K";
-    if (castling_rights[1]) castling += "Q";
-    if (castling_rights[2]) castling += "k";
-    if (castling_rights[3]) castling += "q";
-    if (castling.is_empty()) castling = "-";
-    fen += castling;
-    
-    fen += " ";
-    if (en_passant_target == 255) {
-        fen += "-";
-    } else {
-        fen += square_to_algebraic(en_passant_target);
-    }
-    
-    fen += " " + String::num_int64(halfmove_clock);
-    fen += " " + String::num_int64(fullmove_number);
-    
-    return fen;
-}
-
-// ==================== ATTACK DETECTION ====================
-
-bool Board::is_square_attacked_fast(uint8_t pos, uint8_t attacking_color) const {
-    uint8_t attacker_color = (attacking_color == 0) ? COLOR_WHITE : COLOR_BLACK;
-    
-    // Knight attacks
-    for (int i = 0; i < knight_attack_count[pos]; i++) {
-        uint8_t sq = knight_attack_squares[pos][i];
-        if (GET_PIECE_TYPE(squares[sq]) == PIECE_KNIGHT && GET_COLOR(squares[sq]) == attacker_color) {
-            return true;
-        }
-    }
-    
-    // King attacks
-    for (int i = 0; i < king_attack_count[pos]; i++) {
-        uint8_t sq = king_attack_squares[pos][i];
-        if (GET_PIECE_TYPE(squares[sq]) == PIECE_KING && GET_COLOR(squares[sq]) == attacker_color) {
-            return true;
-        }
-    }
-    
-    // Pawn attacks
-    int pawn_dir = (attacking_color == 0) ? -8 : 8;
-    int file = pos % 8;
-    
-    if (file > 0) {
-        int sq = pos + pawn_dir - 1;
-        if (sq >= 0 && sq < 64) {
-            if (GET_PIECE_TYPE(squares[sq]) == PIECE_PAWN && GET_COLOR(squares[sq]) == attacker_color) {
-                return true;
-            }
-        }
-    }
-    if (file < 7) {
-        int sq = pos + pawn_dir + 1;
-        if (sq >= 0 && sq < 64) {
-            if (GET_PIECE_TYPE(squares[sq]) == PIECE_PAWN && GET_COLOR(squares[sq]) == attacker_color) {
-                return true;
-            }
-        }
-    }
-    
-    // Sliding pieces
-    for (int dir = 0; dir < 8; dir++) {
-        int offset = DIR_OFFSETS[dir];
-        int dist = squares_to_edge[pos][dir];
-        int sq = pos;
-        
-        for (int d = 0; d < dist; d++) {
-            sq += offset;
-            uint8_t piece = squares[sq];
-            
-            if (!IS_EMPTY(piece)) {
-                if (GET_COLOR(piece) == attacker_color) {
-                    uint8_t type = GET_PIECE_TYPE(piece);
-                    if (type == PIECE_QUEEN) return true;
-                    if (dir < 4 && type == PIECE_ROOK) return true;
-                    if (dir >= 4 && type == PIECE_BISHOP) return true;
-                }
-                break;
-            }
-        }
-    }
-    
-    return false;
-}
-
-bool Board::is_king_in_check(uint8_t color) const {
-    uint8_t king_pos = (color == 0) ? white_king_pos : black_king_pos;
-    if (king_pos == 255) return false;
-    return is_square_attacked_fast(king_pos, 1 - color);
-}
-
-bool Board::has_legal_moves() const {
-    MoveList moves;
-    generate_all_pseudo_legal(moves);
-    
-    uint8_t current_color = turn;
-    Board* self = const_cast<Board*>(this);
-    
-    uint8_t ep_before = en_passant_target;
-    bool castling_before[4];
-    for (int i = 0; i < 4; i++) castling_before[i] = castling_rights[i];
-    uint64_t hash_before = current_hash;
-    
-    for (int i = 0; i < moves.count; i++) {
-        FastMove &m = moves.moves[i];
-        
-        self->make_move_fast(m);
-        
-        uint8_t our_king = (current_color == 0) ? white_king_pos : black_king_pos;
-        bool legal = !is_square_attacked_fast(our_king, 1 - current_color);
-        
-        self->unmake_move_fast(m, ep_before, castling_before, hash_before);
-        
-        if (legal) return true;
-    }
-    
-    return false;
-}
-
-// ==================== MOVE GENERATION ====================
-
-inline void Board::generate_pawn_moves(uint8_t pos, MoveList &moves) const {
-    uint8_t piece = squares[pos];
-    uint8_t color = GET_COLOR(piece);
-    int direction = (color == COLOR_WHITE) ? 8 : -8;
-    int start_rank = (color == COLOR_WHITE) ? 1 : 6;
-    int promo_rank = (color == COLOR_WHITE) ? 7 : 0;
-    int rank = pos / 8;
-    int file = pos % 8;
-    
-    int to = pos + direction;
-    if (to >= 0 && to < 64 && IS_EMPTY(squares[to])) {
-        int to_rank = to / 8;
-        if (to_rank == promo_rank) {
-            moves.add(pos, to, (PIECE_QUEEN << 3), 0);
-            moves.add(pos, to, (PIECE_ROOK << 3), 0);
-            moves.add(pos, to, (PIECE_BISHOP << 3), 0);
-            moves.add(pos, to, (PIECE_KNIGHT << 3), 0);
-        } else {
-            moves.add(pos, to);
-        }
-        
-        if (rank == start_rank) {
-            int to2 = pos + 2 * direction;
-            if (IS_EMPTY(squares[to2])) {
-                moves.add(pos, to2);
-            }
-        }
-    }
-    
-    int capture_dirs[2] = {direction - 1, direction + 1};
-    for (int i = 0; i < 2; i++) {
-        int to_sq = pos + capture_dirs[i];
-        if (to_sq < 0 || to_sq >= 64) continue;
-        
-        int to_file = to_sq % 8;
-        int file_diff = to_file - file;
-        if (file_diff < -1 || file_diff > 1) continue;
-        
-        int to_rank = to_sq / 8;
-        
-        if (!IS_EMPTY(squares[to_sq]) && GET_COLOR(squares[to_sq]) != color) {
-            if (to_rank == promo_rank) {
-                moves.add(pos, to_sq, 1 | (PIECE_QUEEN << 3), squares[to_sq]);
-                moves.add(pos, to_sq, 1 | (PIECE_ROOK << 3), squares[to_sq]);
-                moves.add(pos, to_sq, 1 | (PIECE_BISHOP << 3), squares[to_sq]);
-                moves.add(pos, to_sq, 1 | (PIECE_KNIGHT << 3), squares[to_sq]);
-            } else {
-                moves.add(pos, to_sq, 1, squares[to_sq]);
-            }
-        }
-        else if (to_sq == en_passant_target) {
-            int captured_sq = to_sq - direction;
-            moves.add(pos, to_sq, 2, squares[captured_sq]);
-        }
-    }
-}
-
-inline void Board::generate_knight_moves(uint8_t pos, MoveList &moves) const {
-    uint8_t color = GET_COLOR(squares[pos]);
-    
-    for (int i = 0; i < knight_attack_count[pos]; i++) {
-        uint8_t to = knight_attack_squares[pos][i];
-        uint8_t target = squares[to];
-        
-        if (IS_EMPTY(target)) {
-            moves.add(pos, to);
-        } else if (GET_COLOR(target) != color) {
-            moves.add(pos, to, 1, target);
-        }
-    }
-}
-
-inline void Board::generate_bishop_moves(uint8_t pos, MoveList &moves) const {
-    uint8_t color = GET_COLOR(squares[pos]);
-    
-    for (int dir = 4; dir < 8; dir++) {
-        int offset = DIR_OFFSETS[dir];
-        int dist = squares_to_edge[pos][dir];
-        int sq = pos;
-        
-        for (int d = 0; d < dist; d++) {
-            sq += offset;
-            uint8_t target = squares[sq];
-            
-            if (IS_EMPTY(target)) {
-                moves.add(pos, sq);
-            } else {
-                if (GET_COLOR(target) != color) {
-                    moves.add(pos, sq, 1, target);
-                }
-                break;
-            }
-        }
-    }
-}
-
-inline void Board::generate_rook_moves(uint8_t pos, MoveList &moves) const {
-    uint8_t color = GET_COLOR(squares[pos]);
-    
-    for (int dir = 0; dir < 4; dir++) {
-        int offset = DIR_OFFSETS[dir];
-        int dist = squares_to_edge[pos][dir];
-        int sq = pos;
-        
-        for (int d = 0; d < dist; d++) {
-            sq += offset;
-            uint8_t target = squares[sq];
-            
-            if (IS_EMPTY(target)) {
-                moves.add(pos, sq);
-            } else {
-                if (GET_COLOR(target) != color) {
-                    moves.add(pos, sq, 1, target);
-                }
-                break;
-            }
-        }
-    }
-}
-
-inline void Board::generate_queen_moves(uint8_t pos, MoveList &moves) const {
-    generate_rook_moves(pos, moves);
-    generate_bishop_moves(pos, moves);
-}
-
-inline void Board::generate_king_moves(uint8_t pos, MoveList &moves) const {
-    uint8_t color = GET_COLOR(squares[pos]);
-    
-    for (int i = 0; i < king_attack_count[pos]; i++) {
-        uint8_t to = king_attack_squares[pos][i];
-        uint8_t target = squares[to];
-        
-        if (IS_EMPTY(target)) {
-            moves.add(pos, to);
-        } else if (GET_COLOR(target) != color) {
-            moves.add(pos, to, 1, target);
-        }
-    }
-}
-
-inline void Board::generate_castling_moves(uint8_t pos, MoveList &moves) const {
-    uint8_t color_val = GET_COLOR(squares[pos]);
-    uint8_t color = (color_val == COLOR_WHITE) ? 0 : 1;
-    
-    int rights_k = (color == 0) ? 0 : 2;
-    if (castling_rights[rights_k]) {
-        int king_pos = (color == 0) ? 4 : 60;
-        if (pos == king_pos &&
-            IS_EMPTY(squares[king_pos + 1]) && 
-            IS_EMPTY(squares[king_pos + 2]) &&
-            !is_square_attacked_fast(king_pos, 1 - color) &&
-            !is_square_attacked_fast(king_pos + 1, 1 - color) &&
-            !is_square_attacked_fast(king_pos + 2, 1 - color)) {
-            moves.add(pos, pos + 2, 4);
-        }
-    }
-    
-    int rights_q = (color == 0) ? 1 : 3;
-    if (castling_rights[rights_q]) {
-        int king_pos = (color == 0) ? 4 : 60;
-        if (pos == king_pos &&
-            IS_EMPTY(squares[king_pos - 1]) && 
-            IS_EMPTY(squares[king_pos - 2]) &&
-            IS_EMPTY(squares[king_pos - 3]) &&
-            !is_square_attacked_fast(king_pos, 1 - color) &&
-            !is_square_attacked_fast(king_pos - 1, 1 - color) &&
-            !is_square_attacked_fast(king_pos - 2, 1 - color)) {
-            moves.add(pos, pos - 2, 4);
-        }
-    }
-}
-
-void Board::generate_all_pseudo_legal(MoveList &moves) const {
-    moves.clear();
-
-    // Use piece lists for faster iteration (avoid scanning empty squares)
-    const uint8_t* piece_list;
-    uint8_t piece_count;
+// ==================== CONSTRUCTOR/DESTRUCTOR ====================
 
-    if (turn == 0) {
-        piece_list = white_piece_list;
-        piece_count = white_piece_count;
-    } else {
-        piece_list = black_piece_list;
-        piece_count = black_piece_count;
-    }
+Board::Board() {
+    promotion_pending_from = 0;
+    promotion_pending_to = 0;
+    reset_game_state();
+}
 
-    for (uint8_t i = 0; i < piece_count; i++) {
-        uint8_t sq = piece_list[i];
-        uint8_t piece = squares[sq];
+Board::~Board() {
+}
 
-        switch (GET_PIECE_TYPE(piece)) {
-            case PIECE_PAWN:   generate_pawn_moves(sq, moves); break;
-            case PIECE_KNIGHT: generate_knight_moves(sq, moves); break;
-            case PIECE_BISHOP: generate_bishop_moves(sq, moves); break;
-            case PIECE_ROOK:   generate_rook_moves(sq, moves); break;
-            case PIECE_QUEEN:  generate_queen_moves(sq, moves); break;
-            case PIECE_KING:
-                generate_king_moves(sq, moves);
-                generate_castling_moves(sq, moves);
-                break;
-        }
-    }
+void Board::_ready() {
+    initialize_starting_position();
+    reset_game_state();
 }
 
-// ==================== FAST MAKE/UNMAKE ====================
+void Board::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_turn"), &Board::get_turn);
+    ClassDB::bind_method(D_METHOD("get_piece_on_square", "pos"), &Board::get_piece_on_square);
+    ClassDB::bind_method(D_METHOD("get_board_packed"), &Board::get_board_packed);
+    ClassDB::bind_method(D_METHOD("set_piece_on_square", "pos", "piece"), &Board::set_piece_on_square);
+    ClassDB::bind_method(D_METHOD("setup_board", "fen_notation"), &Board::setup_board);
+    ClassDB::bind_method(D_METHOD("get_fen"), &Board::get_fen);
+    ClassDB::bind_method(D_METHOD("load_epd", "path"), &Board::load_epd);
+    ClassDB::bind_method(D_METHOD("get_epd_count"), &Board::get_epd_count);
+    ClassDB::bind_method(D_METHOD("setup_epd_position", "index"), &Board::setup_epd_position);
+    ClassDB::bind_method(D_METHOD("get_epd_record", "index"), &Board::get_epd_record);
+    ClassDB::bind_method(D_METHOD("run_epd_perft", "max_depth", "threads"), &Board::run_epd_perft, DEFVAL(1));
+    ClassDB::bind_method(D_METHOD("attempt_move", "start", "end"), &Board::attempt_move);
+    ClassDB::bind_method(D_METHOD("commit_promotion", "type_str"), &Board::commit_promotion);
+    ClassDB::bind_method(D_METHOD("revert_move"), &Board::revert_move);
+    ClassDB::bind_method(D_METHOD("get_moves"), &Board::get_moves);
+    ClassDB::bind_method(D_METHOD("get_moves_uci"), &Board::get_moves_uci);
+    ClassDB::bind_method(D_METHOD("get_move_count"), &Board::get_move_count);
+    ClassDB::bind_method(D_METHOD("get_last_move"), &Board::get_last_move);
+    ClassDB::bind_method(D_METHOD("export_pgn", "path", "headers"), &Board::export_pgn, DEFVAL(Dictionary()));
+    ClassDB::bind_method(D_METHOD("get_all_possible_moves", "color"), &Board::get_all_possible_moves);
+    ClassDB::bind_method(D_METHOD("get_legal_moves_for_piece", "square"), &Board::get_legal_moves_for_piece);
+    ClassDB::bind_method(D_METHOD("get_perft_analysis", "depth"), &Board::get_perft_analysis);
+    ClassDB::bind_method(D_METHOD("make_move", "start", "end"), &Board::make_move);
+    ClassDB::bind_method(D_METHOD("is_checkmate", "color"), &Board::is_checkmate);
+    ClassDB::bind_method(D_METHOD("is_stalemate", "color"), &Board::is_stalemate);
+    ClassDB::bind_method(D_METHOD("is_check", "color"), &Board::is_check);
+    ClassDB::bind_method(D_METHOD("is_draw_by_material"), &Board::is_draw_by_material);
+    ClassDB::bind_method(D_METHOD("is_game_over"), &Board::is_game_over);
+    ClassDB::bind_method(D_METHOD("get_game_result"), &Board::get_game_result);
+    ClassDB::bind_method(D_METHOD("pos_to_coords", "pos"), &Board::pos_to_coords);
+    ClassDB::bind_method(D_METHOD("coords_to_pos", "rank", "file"), &Board::coords_to_pos);
+    ClassDB::bind_method(D_METHOD("square_to_algebraic", "pos"), &Board::square_to_algebraic);
+    ClassDB::bind_method(D_METHOD("algebraic_to_square", "algebraic"), &Board::algebraic_to_square);
 
-void Board::make_move_fast(const FastMove &m) {
-    uint8_t moving_piece = squares[m.from];
-    uint8_t piece_type = GET_PIECE_TYPE(moving_piece);
-    uint8_t color = GET_COLOR(moving_piece);
-    
-    if (en_passant_target < 64) {
-        hash_en_passant(en_passant_target);
-    }
-    
-    if (m.flags & 2) {
-        int capture_sq = m.to + ((color == COLOR_WHITE) ? -8 : 8);
-        hash_piece(squares[capture_sq], capture_sq);
-        squares[capture_sq] = 0;
-    }
-    
-    if ((m.flags & 1) && !(m.flags & 2)) {
-        hash_piece(squares[m.to], m.to);
-    }
-    
-    if (m.flags & 4) {
-        int move_dist = (int)m.to - (int)m.from;
-        if (move_dist == 2) {
-            hash_piece(squares[m.from + 3], m.from + 3);
-            hash_piece(squares[m.from + 3], m.from + 1);
-            squares[m.from + 1] = squares[m.from + 3];
-            squares[m.from + 3] = 0;
-        } else {
-            hash_piece(squares[m.from - 4], m.from - 4);
-            hash_piece(squares[m.from - 4], m.from - 1);
-            squares[m.from - 1] = squares[m.from - 4];
-            squares[m.from - 4] = 0;
-        }
-    }
-    
-    hash_piece(moving_piece, m.from);
-    
-    squares[m.to] = moving_piece;
-    squares[m.from] = 0;
-    
-    uint8_t promo_piece = (m.flags >> 3) & 7;
-    if (promo_piece) {
-        squares[m.to] = MAKE_PIECE(promo_piece, color);
-        hash_piece(squares[m.to], m.to);
-    } else {
-        hash_piece(moving_piece, m.to);
-    }
-    
-    if (piece_type == PIECE_KING) {
-        if (color == COLOR_WHITE) white_king_pos = m.to;
-        else black_king_pos = m.to;
-    }
-    
-    en_passant_target = 255;
-    if (piece_type == PIECE_PAWN) {
-        int move_dist = (int)m.to - (int)m.from;
-        if (move_dist == 16 || move_dist == -16) {
-            en_passant_target = (m.from + m.to) / 2;
-            hash_en_passant(en_passant_target);
-        }
-    }
-    
-    if (piece_type == PIECE_KING) {
-        if (color == COLOR_WHITE) {
-            if (castling_rights[0]) { hash_castling(0); castling_rights[0] = false; }
-            if (castling_rights[1]) { hash_castling(1); castling_rights[1] = false; }
-        } else {
-            if (castling_rights[2]) { hash_castling(2); castling_rights[2] = false; }
-            if (castling_rights[3]) { hash_castling(3); castling_rights[3] = false; }
-        }
-    }
-    
-    if ((m.from == 0 || m.to == 0) && castling_rights[1]) { hash_castling(1); castling_rights[1] = false; }
-    if ((m.from == 7 || m.to == 7) && castling_rights[0]) { hash_castling(0); castling_rights[0] = false; }
-    if ((m.from == 56 || m.to == 56) && castling_rights[3]) { hash_castling(3); castling_rights[3] = false; }
-    if ((m.from == 63 || m.to == 63) && castling_rights[2]) { hash_castling(2); castling_rights[2] = false; }
-    
-    hash_side();
-    turn = 1 - turn;
+    // diff: PackedByteArray of (square, new piece) pairs for every square that changed
+    ADD_SIGNAL(MethodInfo("board_changed", PropertyInfo(Variant::PACKED_BYTE_ARRAY, "diff")));
 }
 
-void Board::unmake_move_fast(const FastMove &m, uint8_t ep_before, bool castling_before[4], uint64_t hash_before) {
-    uint8_t moving_piece = squares[m.to];
-    uint8_t color = GET_COLOR(moving_piece);
-    uint8_t piece_type = GET_PIECE_TYPE(moving_piece);
-    
-    uint8_t promo_piece = (m.flags >> 3) & 7;
-    if (promo_piece) {
-        moving_piece = MAKE_PIECE(PIECE_PAWN, color);
-        piece_type = PIECE_PAWN;
-    }
-    
-    squares[m.from] = moving_piece;
-    squares[m.to] = (m.flags & 2) ? 0 : m.captured;
-    
-    if (m.flags & 2) {
-        int capture_sq = m.to + ((color == COLOR_WHITE) ? -8 : 8);
-        squares[capture_sq] = m.captured;
-    }
-    
-    if (m.flags & 4) {
-        int move_dist = (int)m.to - (int)m.from;
-        if (move_dist == 2) {
-            squares[m.from + 3] = squares[m.from + 1];
-            squares[m.from + 1] = 0;
-        } else {
-            squares[m.from - 4] = squares[m.from - 1];
-            squares[m.from - 1] = 0;
-        }
-    }
-    
-    if (piece_type == PIECE_KING) {
-        if (color == COLOR_WHITE) white_king_pos = m.from;
-        else black_king_pos = m.from;
-    }
-    
-    for (int i = 0; i < 4; i++) castling_rights[i] = castling_before[i];
-    en_passant_target = ep_before;
-    current_hash = hash_before;
-    turn = 1 - turn;
+// ==================== BOARD SETUP ====================
+
+// Forget the game history (after the position was replaced wholesale)
+void Board::reset_game_state() {
+    history_count = 0;
+    promotion_pending = false;
 }
 
 // ==================== LEGACY API HELPERS ====================
@@ -1006,8 +229,7 @@ void Board::add_king_moves(uint8_t pos, Array &moves) const {
 }
 
 bool Board::can_castle_kingside(uint8_t color) const {
-    int rights_idx = (color == 0) ? 0 : 2;
-    if (!castling_rights[rights_idx]) return false;
+    if (!(castling_rights & ((color == 0) ? CASTLE_WHITE_KINGSIDE : CASTLE_BLACK_KINGSIDE))) return false;
     
     int king_pos = (color == 0) ? 4 : 60;
     
@@ -1023,8 +245,7 @@ bool Board::can_castle_kingside(uint8_t color) const {
 }
 
 bool Board::can_castle_queenside(uint8_t color) const {
-    int rights_idx = (color == 0) ? 1 : 3;
-    if (!castling_rights[rights_idx]) return false;
+    if (!(castling_rights & ((color == 0) ? CASTLE_WHITE_QUEENSIDE : CASTLE_BLACK_QUEENSIDE))) return false;
     
     int king_pos = (color == 0) ? 4 : 60;
     
@@ -1074,187 +295,217 @@ Array Board::get_pseudo_legal_moves_for_piece(uint8_t pos) const {
     return moves;
 }
 
-void Board::make_move_internal(uint8_t from, uint8_t to, Move &move_record) {
-    uint8_t moving_piece = squares[from];
-    uint8_t piece_type = GET_PIECE_TYPE(moving_piece);
-    uint8_t color = GET_COLOR(moving_piece);
-    
-    move_record.from = from;
-    move_record.to = to;
-    move_record.captured_piece = squares[to];
-    move_record.promotion_piece = 0;
-    move_record.is_castling = false;
-    move_record.is_en_passant = false;
-    move_record.en_passant_target_before = en_passant_target;
-    move_record.halfmove_clock_before = halfmove_clock;
-    move_record.hash_before = current_hash;
-    for (int i = 0; i < 4; i++) {
-        move_record.castling_rights_before[i] = castling_rights[i];
-    }
+String Board::move_to_notation(const Move &move) const {
+    String notation = "";
+    notation += square_to_algebraic(move.from);
+    notation += square_to_algebraic(move.to);
     
-    if (en_passant_target < 64) {
-        hash_en_passant(en_passant_target);
+    if (move.promotion_piece != 0) {
+        switch (GET_PIECE_TYPE(move.promotion_piece)) {
+            case PIECE_QUEEN:  notation += "q"; break;
+            case PIECE_ROOK:   notation += "r"; break;
+            case PIECE_BISHOP: notation += "b"; break;
+            case PIECE_KNIGHT: notation += "n"; break;
+        }
     }
     
-    if (piece_type == PIECE_PAWN && to == en_passant_target) {
-        move_record.is_en_passant = true;
-        int capture_sq = to + ((color == COLOR_WHITE) ? -8 : 8);
-        move_record.captured_piece = squares[capture_sq];
-        hash_piece(squares[capture_sq], capture_sq);
-        squares[capture_sq] = 0;
+    return notation;
+}
+
+// ==================== SAN / HISTORY REPLAY ====================
+
+static const char SAN_PIECE_LETTERS[7] = {' ', 'P', 'N', 'B', 'R', 'Q', 'K'};
+
+bool Board::history_full() const {
+    if (history_count < MAX_GAME_PLY) return false;
+    UtilityFunctions::print("Error: Game history is full (", MAX_GAME_PLY, " plies)");
+    return true;
+}
+
+Position Board::history_start() const {
+    Position pos = *this;
+    for (int i = history_count - 1; i >= 0; i--) {
+        pos.revert_move_internal(move_history[i]);
     }
+    return pos;
+}
+
+void Board::replay_move(Position &pos, const Move &move) {
+    Move record;
+    pos.make_move_internal(move.from, move.to, record);
     
-    if (!move_record.is_en_passant && !IS_EMPTY(squares[to])) {
-        hash_piece(squares[to], to);
+    if (move.promotion_piece != 0) {
+        pos.hash_piece(pos.squares[move.to], move.to);
+        pos.squares[move.to] = move.promotion_piece;
+        pos.hash_piece(pos.squares[move.to], move.to);
     }
-    
-    if (piece_type == PIECE_KING) {
-        int move_dist = (int)to - (int)from;
-        
-        if (move_dist == 2) {
-            move_record.is_castling = true;
-            uint8_t rook = squares[from + 3];
-            hash_piece(rook, from + 3);
-            hash_piece(rook, from + 1);
-            squares[from + 3] = 0;
-            squares[from + 1] = rook;
-        } else if (move_dist == -2) {
-            move_record.is_castling = true;
-            uint8_t rook = squares[from - 4];
-            hash_piece(rook, from - 4);
-            hash_piece(rook, from - 1);
-            squares[from - 4] = 0;
-            squares[from - 1] = rook;
-        }
+}
+
+String Board::move_to_san(Position &pos, const Move &move) const {
+    if (move.is_castling) {
+        return (move.to > move.from) ? "O-O" : "O-O-O";
     }
     
-    hash_piece(moving_piece, from);
-    hash_piece(moving_piece, to);
-    
-    squares[to] = moving_piece;
-    squares[from] = 0;
-    
-    if (piece_type == PIECE_KING) {
-        if (color == COLOR_WHITE) white_king_pos = to;
-        else black_king_pos = to;
-    }
+    uint8_t piece = pos.squares[move.from];
+    uint8_t piece_type = GET_PIECE_TYPE(piece);
+    bool is_capture = move.is_en_passant || !IS_EMPTY(move.captured_piece);
+    String san = "";
     
-    en_passant_target = 255;
     if (piece_type == PIECE_PAWN) {
-        int move_dist = (int)to - (int)from;
-        if (move_dist == 16 || move_dist == -16) {
-            en_passant_target = (from + to) / 2;
-            hash_en_passant(en_passant_target);
+        if (is_capture) {
+            san += String::chr('a' + move.from % 8);
+            san += "x";
         }
-    }
-    
-    if (piece_type == PIECE_KING) {
-        if (color == COLOR_WHITE) {
-            if (castling_rights[0]) { hash_castling(0); castling_rights[0] = false; }
-            if (castling_rights[1]) { hash_castling(1); castling_rights[1] = false; }
-        } else {
-            if (castling_rights[2]) { hash_castling(2); castling_rights[2] = false; }
-            if (castling_rights[3]) { hash_castling(3); castling_rights[3] = false; }
+        san += square_to_algebraic(move.to);
+        if (move.promotion_piece != 0) {
+            san += "=";
+            san += String::chr(SAN_PIECE_LETTERS[GET_PIECE_TYPE(move.promotion_piece)]);
         }
+        return san;
     }
     
-    if ((from == 0 || to == 0) && castling_rights[1]) { hash_castling(1); castling_rights[1] = false; }
-    if ((from == 7 || to == 7) && castling_rights[0]) { hash_castling(0); castling_rights[0] = false; }
-    if ((from == 56 || to == 56) && castling_rights[3]) { hash_castling(3); castling_rights[3] = false; }
-    if ((from == 63 || to == 63) && castling_rights[2]) { hash_castling(2); castling_rights[2] = false; }
+    san += String::chr(SAN_PIECE_LETTERS[piece_type]);
     
-    if (piece_type == PIECE_PAWN || move_record.captured_piece != 0) {
-        halfmove_clock = 0;
-    } else {
-        halfmove_clock++;
+    // Disambiguate against other identical pieces that can legally reach the same square
+    if (piece_type != PIECE_KING) {
+        MoveList legal;
+        pos.generate_legal_moves(legal);
+        
+        bool ambiguous = false;
+        bool shares_file = false;
+        bool shares_rank = false;
+        for (int i = 0; i < legal.count; i++) {
+            const FastMove &m = legal.moves[i];
+            if (m.to != move.to || m.from == move.from || pos.squares[m.from] != piece) continue;
+            ambiguous = true;
+            if (m.from % 8 == move.from % 8) shares_file = true;
+            if (m.from / 8 == move.from / 8) shares_rank = true;
+        }
+        
+        if (ambiguous) {
+            if (!shares_file) {
+                san += String::chr('a' + move.from % 8);
+            } else if (!shares_rank) {
+                san += String::chr('1' + move.from / 8);
+            } else {
+                san += square_to_algebraic(move.from);
+            }
+        }
     }
     
-    if (color == COLOR_BLACK) {
-        fullmove_number++;
-    }
+    if (is_capture) san += "x";
+    san += square_to_algebraic(move.to);
     
-    hash_side();
-    turn = 1 - turn;
+    return san;
 }
 
-void Board::revert_move_internal(const Move &move) {
-    uint8_t moving_piece = squares[move.to];
-    uint8_t color = GET_COLOR(moving_piece);
-    uint8_t piece_type = GET_PIECE_TYPE(moving_piece);
-    
-    if (move.promotion_piece != 0) {
-        moving_piece = MAKE_PIECE(PIECE_PAWN, color);
-    }
-    
-    squares[move.from] = moving_piece;
-    squares[move.to] = move.captured_piece;
-    
-    if (move.is_en_passant) {
-        squares[move.to] = 0;
-        int capture_sq = move.to + ((color == COLOR_WHITE) ? -8 : 8);
-        squares[capture_sq] = move.captured_piece;
+String Board::check_suffix(Position &pos) {
+    if (!pos.is_king_in_check(pos.turn)) return "";
+    return pos.has_legal_moves() ? "+" : "#";
+}
+
+// ==================== PUBLIC API ====================
+
+void Board::setup_board(const String &fen_notation) {
+    CharString fen = fen_notation.utf8();
+    if (!parse_fen(std::string_view(fen.get_data(), fen.length()))) {
+        initialize_starting_position();
     }
+    reset_game_state();
+}
+
+String Board::get_fen() const {
+    return String::utf8(to_fen().c_str());
+}
+
+// ==================== EPD SUITES ====================
+
+int64_t Board::load_epd(const String &path) {
+    String global_path = ProjectSettings::get_singleton()->globalize_path(path);
+    CharString path_utf8 = global_path.utf8();
     
-    if (move.is_castling) {
-        int move_dist = (int)move.to - (int)move.from;
-        if (move_dist == 2) {
-            uint8_t rook = squares[move.from + 1];
-            squares[move.from + 1] = 0;
-            squares[move.from + 3] = rook;
-        } else {
-            uint8_t rook = squares[move.from - 1];
-            squares[move.from - 1] = 0;
-            squares[move.from - 4] = rook;
-        }
-    }
+    epd_positions.clear();
+    epd_ops.clear();
     
-    if (GET_PIECE_TYPE(moving_piece) == PIECE_KING) {
-        if (color == COLOR_WHITE) white_king_pos = move.from;
-        else black_king_pos = move.from;
+    uint64_t errors = 0;
+    int64_t loaded = Epd::load_file(path_utf8.get_data(), epd_positions, &epd_ops, &errors);
+    if (loaded < 0) {
+        UtilityFunctions::print("Error: Cannot open EPD file: ", path);
+        return -1;
     }
     
-    for (int i = 0; i < 4; i++) {
-        castling_rights[i] = move.castling_rights_before[i];
+    if (errors > 0) {
+        UtilityFunctions::print("Warning: Skipped ", errors, " malformed EPD lines in ", path);
     }
+    return loaded;
+}
+
+bool Board::setup_epd_position(int64_t index) {
+    if (index < 0 || index >= (int64_t)epd_positions.size()) return false;
     
-    en_passant_target = move.en_passant_target_before;
-    halfmove_clock = move.halfmove_clock_before;
-    current_hash = move.hash_before;
-    
-    turn = 1 - turn;
-    
-    if (color == COLOR_BLACK) {
-        fullmove_number--;
-    }
+    static_cast<Position &>(*this) = epd_positions[index];
+    reset_game_state();
+    return true;
 }
 
-String Board::move_to_notation(const Move &move) const {
-    String notation = "";
-    notation += square_to_algebraic(move.from);
-    notation += square_to_algebraic(move.to);
+Dictionary Board::get_epd_record(int64_t index) const {
+    Dictionary record;
+    if (index < 0 || index >= (int64_t)epd_positions.size()) return record;
     
-    if (move.promotion_piece != 0) {
-        switch (GET_PIECE_TYPE(move.promotion_piece)) {
-            case PIECE_QUEEN:  notation += "q"; break;
-            case PIECE_ROOK:   notation += "r"; break;
-            case PIECE_BISHOP: notation += "b"; break;
-            case PIECE_KNIGHT: notation += "n"; break;
-        }
+    const EpdOps &ops = epd_ops[index];
+    record["fen"] = String::utf8(epd_positions[index].to_fen().c_str());
+    record["id"] = String::utf8(ops.id.c_str());
+    record["c0"] = String::utf8(ops.comment.c_str());
+    record["bm"] = String::utf8(ops.best_moves.c_str());
+    record["am"] = String::utf8(ops.avoid_moves.c_str());
+    
+    Dictionary perft;
+    for (int depth = 1; depth <= EPD_MAX_PERFT_DEPTH; depth++) {
+        if (ops.perft[depth] > 0) perft[depth] = ops.perft[depth];
     }
+    record["perft"] = perft;
     
-    return notation;
+    return record;
 }
 
-// ==================== PUBLIC API ====================
+Dictionary Board::run_epd_perft(int max_depth, int threads) {
+    auto start_time = std::chrono::steady_clock::now();
+    max_depth = std::min(max_depth, EPD_MAX_PERFT_DEPTH);
 
-void Board::setup_board(const String &fen_notation) {
-    if (!parse_fen(fen_notation)) {
-        initialize_starting_position();
+    int64_t checked = 0;
+    uint64_t nodes = 0;
+    Array failures;
+
+    for (size_t index = 0; index < epd_positions.size(); index++) {
+        for (int depth = 1; depth <= max_depth; depth++) {
+            const uint64_t expected = epd_ops[index].perft[depth];
+            if (expected == 0) continue;
+
+            Position pos = epd_positions[index];
+            const uint64_t actual = (threads == 1)
+                ? pos.count_all_moves(static_cast<uint8_t>(depth))
+                : pos.count_all_moves_parallel(static_cast<uint8_t>(depth), threads);
+            nodes += actual;
+            checked++;
+
+            if (actual != expected) {
+                Dictionary failure;
+                failure["index"] = static_cast<int64_t>(index);
+                failure["depth"] = depth;
+                failure["expected"] = expected;
+                failure["actual"] = actual;
+                failures.append(failure);
+            }
+        }
     }
-}
 
-String Board::get_fen() const {
-    return generate_fen();
+    Dictionary result;
+    result["checked"] = checked;
+    result["nodes"] = nodes;
+    result["failures"] = failures;
+    result["seconds"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    result["state_verification"] = Position::state_verification_enabled();
+    return result;
 }
 
 uint8_t Board::get_turn() const {
@@ -1279,10 +530,9 @@ void Board::set_piece_on_square(uint8_t pos, uint8_t piece) {
         hash_piece(piece, pos);
     }
     
-    if (GET_PIECE_TYPE(piece) == PIECE_KING) {
-        if (IS_WHITE(piece)) white_king_pos = pos;
-        else black_king_pos = pos;
-    }
+    // Editing is rare, so just rebuild the derived state
+    update_king_cache();
+    rebuild_piece_lists();
 }
 
 uint8_t Board::attempt_move(uint8_t start, uint8_t end) {
@@ -1309,6 +559,8 @@ uint8_t Board::attempt_move(uint8_t start, uint8_t end) {
     uint8_t piece_type = GET_PIECE_TYPE(piece);
     int end_rank = end / 8;
     
+    if (history_full()) return 0;
+    
     if (piece_type == PIECE_PAWN && (end_rank == 0 || end_rank == 7)) {
         promotion_pending = true;
         promotion_pending_from = start;
@@ -1316,11 +568,14 @@ uint8_t Board::attempt_move(uint8_t start, uint8_t end) {
         return 2;
     }
     
+    uint8_t before[64];
+    memcpy(before, squares, sizeof(squares));
+    
     Move move_record;
     make_move_internal(start, end, move_record);
-    move_history.push_back(move_record);
-    move_history_notation.push_back(move_to_notation(move_record));
+    move_history[history_count++] = move_record;
     
+    emit_board_changed(before);
     return 1;
 }
 
@@ -1341,6 +596,9 @@ void Board::commit_promotion(const String &type_str) {
     uint8_t piece = squares[promotion_pending_from];
     uint8_t color = GET_COLOR(piece);
     
+    uint8_t before[64];
+    memcpy(before, squares, sizeof(squares));
+    
     Move move_record;
     make_move_internal(promotion_pending_from, promotion_pending_to, move_record);
     
@@ -1350,30 +608,170 @@ void Board::commit_promotion(const String &type_str) {
     
     move_record.promotion_piece = squares[promotion_pending_to];
     
-    move_history.push_back(move_record);
-    move_history_notation.push_back(move_to_notation(move_record));
+    move_history[history_count++] = move_record;
     
     promotion_pending = false;
+    emit_board_changed(before);
 }
 
 void Board::revert_move() {
-    if (move_history.empty()) return;
+    if (history_count == 0) return;
+    
+    uint8_t before[64];
+    memcpy(before, squares, sizeof(squares));
+    
+    revert_move_internal(move_history[--history_count]);
+    emit_board_changed(before);
+}
+
+void Board::emit_board_changed(const uint8_t before[64]) {
+    PackedByteArray diff;
+    for (int sq = 0; sq < 64; sq++) {
+        if (squares[sq] != before[sq]) {
+            diff.append(sq);
+            diff.append(squares[sq]);
+        }
+    }
+    if (diff.size() > 0) {
+        emit_signal("board_changed", diff);
+    }
+}
+
+PackedByteArray Board::get_board_packed() const {
+    PackedByteArray packed;
+    packed.resize(PACKED_BOARD_SIZE);
+    uint8_t *data = packed.ptrw();
+    
+    memcpy(data, squares, 64);
+    data[PACKED_TURN] = turn;
     
-    Move last_move = move_history.back();
-    move_history.pop_back();
-    move_history_notation.pop_back();
+    data[PACKED_CASTLING] = castling_rights;
+    data[PACKED_EN_PASSANT] = en_passant_target;
+    
+    data[PACKED_LAST_FROM] = 255;
+    data[PACKED_LAST_TO] = 255;
+    if (history_count > 0) {
+        data[PACKED_LAST_FROM] = move_history[history_count - 1].from;
+        data[PACKED_LAST_TO] = move_history[history_count - 1].to;
+    }
     
-    revert_move_internal(last_move);
+    return packed;
 }
 
 Array Board::get_moves() const {
+    // SAN depends on the position before each move, so replay the history
+    // from the start position on a copy
+    Position pos = history_start();
     Array moves;
-    for (size_t i = 0; i < move_history_notation.size(); i++) {
-        moves.append(move_history_notation[i]);
+    
+    for (int i = 0; i < history_count; i++) {
+        String san = move_to_san(pos, move_history[i]);
+        replay_move(pos, move_history[i]);
+        san += check_suffix(pos);
+        moves.append(san);
+    }
+    
+    return moves;
+}
+
+Array Board::get_moves_uci() const {
+    Array moves;
+    for (int i = 0; i < history_count; i++) {
+        moves.append(move_to_notation(move_history[i]));
     }
     return moves;
 }
 
+Dictionary Board::get_last_move() const {
+    Dictionary result;
+    if (history_count == 0) return result;
+    
+    const Move &last = move_history[history_count - 1];
+    result["from"] = last.from;
+    result["to"] = last.to;
+    return result;
+}
+
+bool Board::export_pgn(const String &path, const Dictionary &headers) {
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+    if (file.is_null()) {
+        UtilityFunctions::print("Error: Cannot open file for writing: ", path);
+        return false;
+    }
+    
+    String result_str = "*";
+    switch (get_game_result()) {
+        case 1: result_str = "1-0"; break;
+        case 2: result_str = "0-1"; break;
+        case 3: result_str = "1/2-1/2"; break;
+    }
+    
+    // Seven Tag Roster defaults, overridden by the caller's headers
+    Dictionary tags;
+    tags["Event"] = "?";
+    tags["Site"] = "?";
+    tags["Date"] = "????.??.??";
+    tags["Round"] = "?";
+    tags["White"] = "?";
+    tags["Black"] = "?";
+    tags["Result"] = result_str;
+    
+    Position pos = history_start();
+    String start_fen = String::utf8(pos.to_fen().c_str());
+    if (start_fen != "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") {
+        tags["SetUp"] = "1";
+        tags["FEN"] = start_fen;
+    }
+    
+    Array header_keys = headers.keys();
+    for (int i = 0; i < header_keys.size(); i++) {
+        tags[header_keys[i]] = headers[header_keys[i]];
+    }
+    
+    Array tag_keys = tags.keys();
+    for (int i = 0; i < tag_keys.size(); i++) {
+        String key = tag_keys[i];
+        String value = tags[key];
+        file->store_line("[" + key + " \"" + value + "\"]");
+    }
+    file->store_line("");
+    
+    // Movetext is replayed and written line by line (wrapped at 80 columns)
+    String line = "";
+    for (int i = 0; i < history_count; i++) {
+        String token = "";
+        if (pos.turn == 0) {
+            token += String::num_int64(pos.fullmove_number) + ". ";
+        } else if (i == 0) {
+            token += String::num_int64(pos.fullmove_number) + "... ";
+        }
+        
+        token += move_to_san(pos, move_history[i]);
+        replay_move(pos, move_history[i]);
+        token += check_suffix(pos);
+        
+        if (line.length() + 1 + token.length() > 79) {
+            file->store_line(line);
+            line = "";
+        }
+        if (!line.is_empty()) line += " ";
+        line += token;
+    }
+    
+    String result_token = tags["Result"];
+    if (line.length() + 1 + result_token.length() > 79) {
+        file->store_line(line);
+        line = "";
+    }
+    if (!line.is_empty()) line += " ";
+    line += result_token;
+    file->store_line(line);
+    file->store_line("");
+    
+    file->close();
+    return true;
+}
+
 Array Board::get_all_possible_moves(uint8_t color) {
     Array all_moves;
     uint8_t target_color = (color == 0) ? COLOR_WHITE : COLOR_BLACK;
@@ -1427,6 +825,11 @@ void Board::make_move(uint8_t start, uint8_t end) {
     uint8_t piece_type = GET_PIECE_TYPE(piece);
     int end_rank = end / 8;
     
+    if (history_full()) return;
+    
+    uint8_t before[64];
+    memcpy(before, squares, sizeof(squares));
+    
     Move move_record;
     make_move_internal(start, end, move_record);
     
@@ -1438,8 +841,8 @@ void Board::make_move(uint8_t start, uint8_t end) {
         move_record.promotion_piece = squares[end];
     }
     
-    move_history.push_back(move_record);
-    move_history_notation.push_back(move_to_notation(move_record));
+    move_history[history_count++] = move_record;
+    emit_board_changed(before);
 }
 
 bool Board::is_checkmate(uint8_t color) {
@@ -1458,9 +861,14 @@ bool Board::is_check(uint8_t color) const {
     return is_king_in_check(color);
 }
 
+bool Board::is_draw_by_material() const {
+    return is_insufficient_material();
+}
+
 bool Board::is_game_over() {
     if (is_checkmate(turn) || is_stalemate(turn)) return true;
     if (halfmove_clock >= 100) return true;
+    if (is_insufficient_material()) return true;
     return false;
 }
 
@@ -1469,76 +877,36 @@ int Board::get_game_result() {
     if (is_checkmate(1)) return 1;
     if (is_stalemate(turn)) return 3;
     if (halfmove_clock >= 100) return 3;
+    if (is_insufficient_material()) return 3;
     return 0;
 }
 
 // ==================== PERFT ====================
 
-uint64_t Board::count_all_moves(uint8_t depth) {
-    if (depth == 0) return 1;
-    
-    MoveList moves;
-    generate_all_pseudo_legal(moves);
-    
-    uint64_t nodes = 0;
-    uint8_t current_color = turn;
-    
-    uint8_t ep_before = en_passant_target;
-    bool castling_before[4];
-    for (int i = 0; i < 4; i++) castling_before[i] = castling_rights[i];
-    uint64_t hash_before = current_hash;
-    
-    for (int i = 0; i < moves.count; i++) {
-        FastMove &m = moves.moves[i];
-        
-        make_move_fast(m);
-        
-        uint8_t our_king = (current_color == 0) ? white_king_pos : black_king_pos;
-        if (!is_square_attacked_fast(our_king, 1 - current_color)) {
-            nodes += count_all_moves(depth - 1);
-        }
-        
-        unmake_move_fast(m, ep_before, castling_before, hash_before);
-    }
-    
-    return nodes;
-}
-
 Dictionary Board::get_perft_analysis(uint8_t depth) {
     Dictionary result;
-    MoveList moves;
-    generate_all_pseudo_legal(moves);
+    // Depth 0 is the root alone: no moves to divide (depth - 1 would wrap to 255)
+    if (depth == 0) return result;
 
-    uint8_t current_color = turn;
-    uint8_t ep_before = en_passant_target;
-    bool castling_before[4];
-    for (int i = 0; i < 4; i++) castling_before[i] = castling_rights[i];
-    uint64_t hash_before = current_hash;
+    MoveList moves;
+    generate_legal_moves(moves);
     
     for (int i = 0; i < moves.count; i++) {
         FastMove &m = moves.moves[i];
-
-        make_move_fast(m);
-
-        uint8_t our_king = (current_color == 0) ? white_king_pos : black_king_pos;
-        if (!is_square_attacked_fast(our_king, 1 - current_color)) {
-            uint64_t nodes = count_all_moves(depth - 1);
-            String move_notation = square_to_algebraic(m.from) + square_to_algebraic(m.to);
-            
-            uint8_t promo_piece = (m.flags >> 3) & 7;
-            if (promo_piece) {
-                switch (promo_piece) {
-                    case PIECE_QUEEN:  move_notation += "q"; break;
-                    case PIECE_ROOK:   move_notation += "r"; break;
-                    case PIECE_BISHOP: move_notation += "b"; break;
-                    case PIECE_KNIGHT: move_notation += "n"; break;
-                }
+        uint64_t nodes = after(m).count_all_moves_copy(depth - 1);
+        String move_notation = square_to_algebraic(m.from) + square_to_algebraic(m.to);
+        
+        uint8_t promo_piece = (m.flags >> 3) & 7;
+        if (promo_piece) {
+            switch (promo_piece) {
+                case PIECE_QUEEN:  move_notation += "q"; break;
+                case PIECE_ROOK:   move_notation += "r"; break;
+                case PIECE_BISHOP: move_notation += "b"; break;
+                case PIECE_KNIGHT: move_notation += "n"; break;
             }
-            
-            result[move_notation] = nodes;
         }
-
-        unmake_move_fast(m, ep_before, castling_before, hash_before);
+        
+        result[move_notation] = nodes;
     }
 
     return result;
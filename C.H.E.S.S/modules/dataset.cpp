@@ -0,0 +1,706 @@
+#include "dataset.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 64-bit file offsets (PGN archives are often larger than 2 GB)
+#ifdef _WIN32
+#define dataset_fseek _fseeki64
+#define dataset_ftell _ftelli64
+#else
+#define dataset_fseek fseeko
+#define dataset_ftell ftello
+#endif
+
+// ==================== PACKED POSITION ====================
+
+void pack_position(const Position &pos, PackedPosition &packed) {
+    for (int i = 0; i < 32; i++) {
+        uint8_t nibbles[2];
+        for (int j = 0; j < 2; j++) {
+            uint8_t piece = pos.squares[i * 2 + j];
+            nibbles[j] = IS_EMPTY(piece) ? 0 : (GET_PIECE_TYPE(piece) | (IS_BLACK(piece) ? PACKED_BLACK_BIT : 0));
+        }
+        packed.board[i] = nibbles[0] | (nibbles[1] << 4);
+    }
+
+    uint8_t flags = (pos.turn == 1) ? PACKED_FLAG_BLACK_TO_MOVE : 0;
+    flags |= pos.castling_rights << PACKED_CASTLING_SHIFT;
+    packed.flags = flags;
+    packed.en_passant = pos.en_passant_target;
+    packed.halfmove_clock = pos.halfmove_clock;
+    packed.reserved = 0;
+}
+
+bool unpack_position(const PackedPosition &packed, Position &pos) {
+    pos.clear_board();
+
+    int kings[2] = {0, 0};
+    for (int sq = 0; sq < 64; sq++) {
+        uint8_t nibble = (packed.board[sq / 2] >> ((sq & 1) * 4)) & 15;
+        uint8_t type = nibble & PIECE_TYPE_MASK;
+        if (type == PIECE_NONE) continue;
+        if (type > PIECE_KING) return false;
+
+        bool black = (nibble & PACKED_BLACK_BIT) != 0;
+        pos.squares[sq] = MAKE_PIECE(type, black ? COLOR_BLACK : COLOR_WHITE);
+        if (type == PIECE_KING) kings[black ? 1 : 0]++;
+    }
+    if (kings[0] != 1 || kings[1] != 1) return false;
+
+    pos.turn = (packed.flags & PACKED_FLAG_BLACK_TO_MOVE) ? 1 : 0;
+    pos.castling_rights = (packed.flags >> PACKED_CASTLING_SHIFT) & CASTLE_ALL;
+    // Older records may carry a square no pawn can capture on
+    pos.en_passant_target = pos.en_passant_capturable(packed.en_passant) ? packed.en_passant : 255;
+    pos.halfmove_clock = packed.halfmove_clock;
+
+    pos.update_king_cache();
+    pos.rebuild_piece_lists();
+    pos.current_hash = pos.calculate_hash();
+    return true;
+}
+
+// ==================== WRITER ====================
+
+bool DatasetWriter::open(const char *path) {
+    close();
+    file = fopen(path, "wb");
+    if (!file) return false;
+
+    // Placeholder header, rewritten with the final count on close()
+    DatasetHeader header;
+    memcpy(header.magic, DATASET_MAGIC, 4);
+    header.version = DATASET_VERSION;
+    header.record_size = sizeof(TrainingRecord);
+    header.reserved = 0;
+    header.record_count = 0;
+    count = 0;
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool DatasetWriter::append(const TrainingRecord *records, size_t n) {
+    if (!file) return false;
+    if (n == 0) return true;
+
+    size_t written = fwrite(records, sizeof(TrainingRecord), n, file);
+    count += written;
+    return written == n;
+}
+
+bool DatasetWriter::close() {
+    if (!file) return false;
+
+    bool ok = dataset_fseek(file, offsetof(DatasetHeader, record_count), SEEK_SET) == 0 &&
+              fwrite(&count, sizeof(count), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
+
+// ==================== READER ====================
+
+static bool read_header(FILE *file, DatasetHeader &header) {
+    if (fread(&header, sizeof(header), 1, file) != 1) return false;
+    return memcmp(header.magic, DATASET_MAGIC, 4) == 0 &&
+           header.version == DATASET_VERSION &&
+           header.record_size == sizeof(TrainingRecord);
+}
+
+bool read_dataset_header(const char *path, DatasetHeader &header) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+    bool ok = read_header(file, header);
+    fclose(file);
+    return ok;
+}
+
+bool DatasetReader::open(const char *path) {
+    close();
+    file = fopen(path, "rb");
+    if (!file) return false;
+
+    if (!read_header(file, header)) {
+        close();
+        return false;
+    }
+    position = 0;
+    return true;
+}
+
+void DatasetReader::close() {
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+size_t DatasetReader::read(TrainingRecord *out, size_t max) {
+    if (!file || position >= header.record_count) return 0;
+
+    size_t wanted = static_cast<size_t>(std::min<uint64_t>(max, header.record_count - position));
+    size_t got = fread(out, sizeof(TrainingRecord), wanted, file);
+    position += got;
+    return got;
+}
+
+bool DatasetReader::seek(uint64_t index) {
+    if (!file || index > header.record_count) return false;
+
+    int64_t offset = static_cast<int64_t>(sizeof(DatasetHeader) + index * sizeof(TrainingRecord));
+    if (dataset_fseek(file, offset, SEEK_SET) != 0) return false;
+    position = index;
+    return true;
+}
+
+// ==================== SHARDED WRITER ====================
+
+std::string dataset_shard_path(const std::string &base_path, int shard) {
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), ".%03d", shard);
+
+    const std::string extension = ".chds";
+    if (base_path.size() > extension.size() &&
+        base_path.compare(base_path.size() - extension.size(), extension.size(), extension) == 0) {
+        return base_path.substr(0, base_path.size() - extension.size()) + suffix + extension;
+    }
+    return base_path + suffix;
+}
+
+bool ShardedDatasetWriter::open(const char *base_path, int shard_count) {
+    close();
+    if (shard_count <= 0) return false;
+
+    for (int i = 0; i < shard_count; i++) {
+        std::string path = dataset_shard_path(base_path, i);
+        std::unique_ptr<DatasetWriter> writer(new DatasetWriter());
+        if (!writer->open(path.c_str())) {
+            close();
+            return false;
+        }
+        shards.push_back(std::move(writer));
+        paths.push_back(path);
+    }
+    return true;
+}
+
+bool ShardedDatasetWriter::append(int shard, const TrainingRecord *records, size_t n) {
+    if (shard < 0 || shard >= static_cast<int>(shards.size())) return false;
+    return shards[shard]->append(records, n);
+}
+
+bool ShardedDatasetWriter::close() {
+    bool ok = !shards.empty();
+    for (std::unique_ptr<DatasetWriter> &writer : shards) {
+        ok = writer->close() && ok;
+    }
+    shards.clear();
+    return ok;
+}
+
+uint64_t ShardedDatasetWriter::get_count() const {
+    uint64_t total = 0;
+    for (const std::unique_ptr<DatasetWriter> &writer : shards) {
+        total += writer->get_count();
+    }
+    return total;
+}
+
+// ==================== EXTERNAL SHUFFLE ====================
+
+ShuffleStats shuffle_dataset(const std::vector<std::string> &input_paths, const char *output_path,
+                             const ShuffleOptions &options) {
+    ShuffleStats stats;
+    auto start_time = std::chrono::steady_clock::now();
+
+    uint64_t total_records = 0;
+    for (const std::string &path : input_paths) {
+        DatasetHeader header;
+        if (!read_dataset_header(path.c_str(), header)) {
+            stats.error = "not a dataset file: " + path;
+            return stats;
+        }
+        total_records += header.record_count;
+    }
+
+    // Random scatter makes shards uneven; leave a quarter of the budget as headroom
+    uint64_t budget_records = std::max<uint64_t>(1, (options.memory_mb << 20) / sizeof(TrainingRecord) * 3 / 4);
+    int shard_count = options.shard_count > 0
+        ? options.shard_count
+        : static_cast<int>(std::max<uint64_t>(1, (total_records + budget_records - 1) / budget_records));
+    stats.shards = shard_count;
+
+    std::mt19937_64 rng(options.seed != 0 ? options.seed : std::random_device()());
+
+    // Pass 1: scatter every record to a random shard
+    const std::string scatter_base = std::string(output_path) + ".tmp";
+    ShardedDatasetWriter scatter;
+    if (!scatter.open(scatter_base.c_str(), shard_count)) {
+        stats.error = "cannot create temporary shard files";
+        return stats;
+    }
+    std::vector<std::string> shard_paths = scatter.get_paths();
+    auto remove_shards = [&]() {
+        for (const std::string &path : shard_paths) remove(path.c_str());
+    };
+
+    const size_t READ_BATCH = 8192;
+    const size_t SHARD_BUFFER = 1024;    // Records buffered per shard between writes
+    std::vector<TrainingRecord> batch(READ_BATCH);
+    std::vector<std::vector<TrainingRecord>> pending(shard_count);
+    for (std::vector<TrainingRecord> &buffer : pending) buffer.reserve(SHARD_BUFFER);
+
+    bool ok = true;
+    for (const std::string &path : input_paths) {
+        DatasetReader reader;
+        if (!reader.open(path.c_str())) {
+            ok = false;
+            break;
+        }
+
+        size_t n;
+        while (ok && (n = reader.read(batch.data(), batch.size())) > 0) {
+            for (size_t i = 0; i < n; i++) {
+                int shard = static_cast<int>(rng() % static_cast<uint64_t>(shard_count));
+                pending[shard].push_back(batch[i]);
+                if (pending[shard].size() == SHARD_BUFFER) {
+                    ok = scatter.append(shard, pending[shard].data(), pending[shard].size()) && ok;
+                    pending[shard].clear();
+                }
+            }
+        }
+    }
+    for (int shard = 0; shard < shard_count && ok; shard++) {
+        ok = scatter.append(shard, pending[shard].data(), pending[shard].size());
+        std::vector<TrainingRecord>().swap(pending[shard]);
+    }
+    ok = scatter.close() && ok;
+    if (!ok) {
+        remove_shards();
+        stats.error = "scatter pass failed";
+        return stats;
+    }
+
+    // Pass 2: shuffle each shard in memory and append it to the output
+    DatasetWriter output;
+    if (!output.open(output_path)) {
+        remove_shards();
+        stats.error = "cannot open output file for writing";
+        return stats;
+    }
+
+    std::vector<TrainingRecord> records;
+    for (const std::string &path : shard_paths) {
+        DatasetReader reader;
+        if (!reader.open(path.c_str())) {
+            ok = false;
+            break;
+        }
+
+        records.resize(static_cast<size_t>(reader.get_count()));
+        ok = reader.read(records.data(), records.size()) == records.size();
+        reader.close();
+        remove(path.c_str());
+        if (!ok) break;
+
+        std::shuffle(records.begin(), records.end(), rng);
+        if (!output.append(records.data(), records.size())) {
+            ok = false;
+            break;
+        }
+    }
+
+    stats.records = output.get_count();
+    ok = output.close() && ok;
+    remove_shards();
+
+    stats.ok = ok && stats.records == total_records;
+    if (!stats.ok) stats.error = "gather pass failed";
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return stats;
+}
+
+// ==================== PGN INGESTION ====================
+
+namespace {
+
+// Records are handed to the shared writer in batches of this size
+const size_t WRITE_BATCH = 8192;
+
+// Reads a byte range of the PGN file line by line
+class LineReader {
+private:
+    FILE *file;
+    std::vector<char> buffer;
+    size_t buffer_pos;
+    size_t buffer_len;
+    int64_t offset;         // File offset of buffer[buffer_pos]
+    int64_t end;
+    std::string long_line;  // Used only for lines that cross a buffer refill
+
+public:
+    LineReader(FILE *p_file, int64_t start, int64_t p_end)
+        : file(p_file), buffer(1 << 22), buffer_pos(0), buffer_len(0), offset(start), end(p_end) {
+        dataset_fseek(file, start, SEEK_SET);
+    }
+
+    // Next line without its terminator; false once the range is exhausted
+    bool next(std::string_view &line) {
+        if (offset >= end) return false;
+        long_line.clear();
+
+        while (true) {
+            if (buffer_pos == buffer_len) {
+                buffer_len = fread(buffer.data(), 1, buffer.size(), file);
+                buffer_pos = 0;
+                if (buffer_len == 0) {
+                    // Unterminated last line
+                    offset = end;
+                    if (long_line.empty()) return false;
+                    line = long_line;
+                    if (line.back() == '\r') line.remove_suffix(1);
+                    return true;
+                }
+            }
+
+            const char *start = buffer.data() + buffer_pos;
+            const char *newline = static_cast<const char *>(memchr(start, '\n', buffer_len - buffer_pos));
+            if (!newline) {
+                long_line.append(start, buffer_len - buffer_pos);
+                offset += buffer_len - buffer_pos;
+                buffer_pos = buffer_len;
+                continue;
+            }
+
+            size_t length = newline - start;
+            buffer_pos += length + 1;
+            offset += length + 1;
+
+            if (long_line.empty()) {
+                line = std::string_view(start, length);
+            } else {
+                long_line.append(start, length);
+                line = long_line;
+            }
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            return true;
+        }
+    }
+};
+
+// Single output file shared under a mutex, or one shard per parser (no locking)
+struct SharedOutput {
+    DatasetWriter writer;
+    ShardedDatasetWriter sharded;
+    bool use_shards = false;
+    std::mutex mutex;
+    std::atomic<bool> write_failed{false};
+};
+
+// Per-thread PGN game parser
+class PgnChunkParser {
+private:
+    const PgnIngestOptions &options;
+    SharedOutput &output;
+    int shard;
+
+    Position pos;
+    std::vector<TrainingRecord> game_records;
+    std::vector<TrainingRecord> batch;
+
+    bool in_movetext;       // Movetext seen since the last tag section
+    bool game_active;       // Tags or moves seen for the current game
+    bool game_bad;          // Bad FEN or illegal SAN: game is dropped
+    int8_t header_result;
+    bool header_result_known;
+    uint16_t ply;
+    int variation_depth;
+    bool in_comment;
+
+public:
+    PgnIngestStats stats;
+
+    PgnChunkParser(const PgnIngestOptions &p_options, SharedOutput &p_output, int p_shard)
+        : options(p_options), output(p_output), shard(p_shard) {
+        batch.reserve(WRITE_BATCH);
+        game_records.reserve(512);
+        start_game();
+    }
+
+    void start_game() {
+        pos.initialize_starting_position();
+        game_records.clear();
+        in_movetext = false;
+        game_active = false;
+        game_bad = false;
+        header_result = RESULT_DRAW;
+        header_result_known = false;
+        ply = 0;
+        variation_depth = 0;
+        in_comment = false;
+    }
+
+    void flush() {
+        if (batch.empty()) return;
+        bool written;
+        if (output.use_shards) {
+            written = output.sharded.append(shard, batch.data(), batch.size());
+        } else {
+            std::lock_guard<std::mutex> lock(output.mutex);
+            written = output.writer.append(batch.data(), batch.size());
+        }
+        if (!written) output.write_failed = true;
+        batch.clear();
+    }
+
+    // known = false for "*" or a game cut off without a result
+    void finish_game(bool known, int8_t result) {
+        if (!game_active) {
+            start_game();
+            return;
+        }
+
+        if (game_bad || (!known && options.skip_unfinished)) {
+            stats.skipped_games++;
+        } else {
+            for (TrainingRecord &record : game_records) {
+                record.result = result;
+                record.target = result_to_target(result);
+                batch.push_back(record);
+                if (batch.size() >= WRITE_BATCH) flush();
+            }
+            stats.games++;
+            stats.positions += game_records.size();
+        }
+        start_game();
+    }
+
+    void parse_tag(std::string_view line) {
+        // [Name "Value"]
+        size_t name_end = line.find(' ');
+        size_t quote_start = line.find('"');
+        size_t quote_end = line.rfind('"');
+        if (name_end == std::string_view::npos || quote_start == std::string_view::npos || quote_end <= quote_start) return;
+
+        std::string_view name = line.substr(1, name_end - 1);
+        std::string_view value = line.substr(quote_start + 1, quote_end - quote_start - 1);
+
+        if (name == "FEN") {
+            if (!pos.parse_fen(value)) game_bad = true;
+        } else if (name == "Result") {
+            header_result_known = true;
+            if (value == "1-0") header_result = RESULT_WHITE_WIN;
+            else if (value == "0-1") header_result = RESULT_BLACK_WIN;
+            else if (value == "1/2-1/2") header_result = RESULT_DRAW;
+            else header_result_known = false;
+        }
+    }
+
+    void play_san(std::string_view san) {
+        if (game_bad) return;
+
+        FastMove move;
+        if (!pos.parse_san(san, move)) {
+            game_bad = true;
+            return;
+        }
+
+        if (ply >= options.min_ply && ply <= options.max_ply) {
+            TrainingRecord record;
+            memset(&record, 0, sizeof(record));
+            pack_position(pos, record.position);
+            record.ply = ply;
+            if (pos.is_king_in_check(pos.turn)) record.flags |= RECORD_FLAG_IN_CHECK;
+            game_records.push_back(record);
+        }
+
+        pos.play_move(move);
+        if (ply < 65535) ply++;
+    }
+
+    void parse_movetext(std::string_view line) {
+        size_t i = 0;
+        while (i < line.size()) {
+            char c = line[i];
+
+            if (in_comment) {
+                if (c == '}') in_comment = false;
+                i++;
+                continue;
+            }
+            if (c == ' ' || c == '\t' || c == '.') { i++; continue; }
+            if (c == '{') { in_comment = true; i++; continue; }
+            if (c == ';') return;  // Rest-of-line comment
+            if (c == '(') { variation_depth++; i++; continue; }
+            if (c == ')') { if (variation_depth > 0) variation_depth--; i++; continue; }
+
+            size_t start = i;
+            while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '{' &&
+                   line[i] != '(' && line[i] != ')' && line[i] != ';') {
+                i++;
+            }
+            std::string_view token = line.substr(start, i - start);
+            if (variation_depth > 0 || token[0] == '$') continue;
+
+            if (token == "1-0") { finish_game(true, RESULT_WHITE_WIN); continue; }
+            if (token == "0-1") { finish_game(true, RESULT_BLACK_WIN); continue; }
+            if (token == "1/2-1/2") { finish_game(true, RESULT_DRAW); continue; }
+            if (token == "*") { finish_game(false, RESULT_DRAW); continue; }
+
+            // Move numbers: "12." / "12..." / "12.e4"
+            size_t digits = 0;
+            while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9') digits++;
+            if (digits > 0 && digits < token.size() && token[digits] == '.') {
+                while (digits < token.size() && token[digits] == '.') digits++;
+                token.remove_prefix(digits);
+                if (token.empty()) continue;
+            } else if (digits == token.size()) {
+                continue;
+            }
+
+            game_active = true;
+            in_movetext = true;
+            play_san(token);
+        }
+    }
+
+    void parse_line(std::string_view line) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string_view::npos) return;
+        line.remove_prefix(start);
+
+        if (!in_comment && line[0] == '[') {
+            // A tag after movetext means the previous game lost its result token
+            if (in_movetext) finish_game(header_result_known, header_result);
+            game_active = true;
+            parse_tag(line);
+            return;
+        }
+        if (!in_comment && line[0] == '%') return;  // Escape line
+
+        parse_movetext(line);
+    }
+
+    void finish_chunk() {
+        if (game_active) finish_game(header_result_known, header_result);
+        flush();
+    }
+};
+
+// Finds the first "[Event " line at or after offset (file size if none)
+int64_t find_game_start(FILE *file, int64_t offset, int64_t file_size) {
+    if (offset <= 0) return 0;
+
+    // Start one byte early so a tag starting exactly at offset is seen after its newline
+    const char *pattern = "\n[Event ";
+    const size_t pattern_len = 8;
+    std::vector<char> buffer(1 << 16);
+    int64_t pos = offset - 1;
+
+    while (pos < file_size) {
+        dataset_fseek(file, pos, SEEK_SET);
+        size_t len = fread(buffer.data(), 1, buffer.size(), file);
+        if (len < pattern_len) break;
+
+        std::string_view view(buffer.data(), len);
+        size_t found = view.find(std::string_view(pattern, pattern_len));
+        if (found != std::string_view::npos) return pos + found + 1;
+
+        // Overlap so a pattern split between reads is still found
+        pos += len - pattern_len + 1;
+    }
+    return file_size;
+}
+
+} // namespace
+
+PgnIngestStats ingest_pgn(const char *pgn_path, const char *dataset_path, const PgnIngestOptions &options) {
+    PgnIngestStats total;
+    auto start_time = std::chrono::steady_clock::now();
+
+    FILE *probe = fopen(pgn_path, "rb");
+    if (!probe) {
+        total.error = "cannot open PGN file";
+        return total;
+    }
+    dataset_fseek(probe, 0, SEEK_END);
+    int64_t file_size = dataset_ftell(probe);
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+    // Chunks smaller than a few MB aren't worth a thread
+    threads = static_cast<int>(std::min<int64_t>(threads, std::max<int64_t>(1, file_size / (4 << 20))));
+
+    // Split points, moved forward to the next game start
+    std::vector<int64_t> bounds;
+    bounds.push_back(0);
+    for (int i = 1; i < threads; i++) {
+        int64_t split = find_game_start(probe, file_size * i / threads, file_size);
+        if (split > bounds.back() && split < file_size) bounds.push_back(split);
+    }
+    bounds.push_back(file_size);
+    fclose(probe);
+
+    size_t chunk_count = bounds.size() - 1;
+
+    SharedOutput output;
+    output.use_shards = options.sharded;
+    bool opened = output.use_shards ? output.sharded.open(dataset_path, static_cast<int>(chunk_count))
+                                    : output.writer.open(dataset_path);
+    if (!opened) {
+        total.error = "cannot open dataset file for writing";
+        return total;
+    }
+
+    std::vector<PgnIngestStats> chunk_stats(chunk_count);
+    std::atomic<bool> open_failed{false};
+    std::vector<std::thread> workers;
+
+    for (size_t c = 0; c < chunk_count; c++) {
+        workers.emplace_back([&, c]() {
+            FILE *file = fopen(pgn_path, "rb");
+            if (!file) {
+                open_failed = true;
+                return;
+            }
+
+            PgnChunkParser parser(options, output, static_cast<int>(c));
+            LineReader reader(file, bounds[c], bounds[c + 1]);
+            std::string_view line;
+            while (reader.next(line)) {
+                parser.parse_line(line);
+            }
+            parser.finish_chunk();
+            fclose(file);
+
+            chunk_stats[c] = parser.stats;
+        });
+    }
+    for (std::thread &worker : workers) worker.join();
+
+    for (const PgnIngestStats &s : chunk_stats) {
+        total.games += s.games;
+        total.skipped_games += s.skipped_games;
+        total.positions += s.positions;
+    }
+    total.bytes = static_cast<uint64_t>(file_size);
+
+    if (output.use_shards) total.shard_paths = output.sharded.get_paths();
+    bool closed = output.use_shards ? output.sharded.close() : output.writer.close();
+    total.ok = closed && !output.write_failed && !open_failed;
+    if (!total.ok) total.error = "write to dataset file failed";
+
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return total;
+}
@@ -0,0 +1,210 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "position.h"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Binary training dataset format (Godot-free)
+//
+// File layout: DatasetHeader followed by record_count fixed-size TrainingRecords.
+// All fields are little-endian. Records carry a packed position plus labels, so
+// datasets can be streamed, split and shuffled without re-parsing any text.
+//
+// Producers: PGN ingestion (DatasetTools.ingest_pgn) and self-play exporters.
+// Consumers: training loops read records in batches with DatasetReader.
+
+#define DATASET_MAGIC "CHDS"
+#define DATASET_VERSION 1
+
+// ==================== PACKED POSITION ====================
+
+// Square nibble: piece type (1-6) with bit 3 set for black, 0 = empty
+#define PACKED_BLACK_BIT 8
+
+// flags byte of PackedPosition
+#define PACKED_FLAG_BLACK_TO_MOVE 1     // bit 0: side to move
+#define PACKED_CASTLING_SHIFT 1         // bits 1-4: castling_rights (CASTLE_* bits)
+
+struct PackedPosition {
+    uint8_t board[32];      // Two squares per byte, low nibble = even square (a1 = square 0)
+    uint8_t flags;          // Side to move + castling rights (see PACKED_FLAG_*)
+    uint8_t en_passant;     // En passant target square or 255
+    uint8_t halfmove_clock;
+    uint8_t reserved;
+};
+
+void pack_position(const Position &pos, PackedPosition &packed);
+
+// Rebuilds a full Position (piece lists, king cache and hash included)
+// Returns false if the packed data is not a plausible position
+bool unpack_position(const PackedPosition &packed, Position &pos);
+
+// ==================== TRAINING RECORD ====================
+
+// Game result from white's point of view
+#define RESULT_BLACK_WIN -1
+#define RESULT_DRAW       0
+#define RESULT_WHITE_WIN  1
+
+// flags byte of TrainingRecord
+#define RECORD_FLAG_HAS_SCORE 1     // score holds an engine evaluation
+#define RECORD_FLAG_IN_CHECK  2     // side to move is in check
+
+struct TrainingRecord {
+    PackedPosition position;
+    float target;           // Training target in [0, 1], white's point of view
+    int16_t score;          // Engine score in centipawns, white's point of view
+    int8_t result;          // RESULT_* of the game this position came from
+    uint8_t flags;          // RECORD_FLAG_*
+    uint16_t ply;           // Half-moves played before this position
+    uint16_t reserved;
+};
+
+static_assert(sizeof(PackedPosition) == 36, "PackedPosition layout changed");
+static_assert(sizeof(TrainingRecord) == 48, "TrainingRecord layout changed");
+
+// Target value for a game result (1.0 white win, 0.5 draw, 0.0 black win)
+inline float result_to_target(int8_t result) {
+    return 0.5f + 0.5f * static_cast<float>(result);
+}
+
+// ==================== FILE HEADER ====================
+
+struct DatasetHeader {
+    char magic[4];          // DATASET_MAGIC
+    uint32_t version;       // DATASET_VERSION
+    uint32_t record_size;   // sizeof(TrainingRecord), guards against layout drift
+    uint32_t reserved;
+    uint64_t record_count;
+};
+
+static_assert(sizeof(DatasetHeader) == 24, "DatasetHeader layout changed");
+
+// ==================== WRITER / READER ====================
+
+// Appends records to a new dataset file. The header's record count is
+// written on close(), so an unclosed file reads as empty
+class DatasetWriter {
+private:
+    FILE *file;
+    uint64_t count;
+
+public:
+    DatasetWriter() : file(nullptr), count(0) {}
+    ~DatasetWriter() { close(); }
+
+    bool open(const char *path);
+    bool append(const TrainingRecord *records, size_t n);
+    bool close();
+
+    bool is_open() const { return file != nullptr; }
+    uint64_t get_count() const { return count; }
+};
+
+// Sequential reader over a dataset file
+class DatasetReader {
+private:
+    FILE *file;
+    DatasetHeader header;
+    uint64_t position;
+
+public:
+    DatasetReader() : file(nullptr), position(0) { memset(&header, 0, sizeof(header)); }
+    ~DatasetReader() { close(); }
+
+    // Fails on a missing file, bad magic/version or record size mismatch
+    bool open(const char *path);
+    void close();
+
+    // Reads up to max records, returns how many were read (0 at the end)
+    size_t read(TrainingRecord *out, size_t max);
+
+    // Random access: next read() starts at record index
+    bool seek(uint64_t index);
+
+    bool is_open() const { return file != nullptr; }
+    uint64_t get_count() const { return header.record_count; }
+    uint64_t get_position() const { return position; }
+};
+
+// Reads just the header of a dataset file (false if it isn't one)
+bool read_dataset_header(const char *path, DatasetHeader &header);
+
+// ==================== SHARDED WRITER ====================
+
+// Path of one shard: "games.chds" -> "games.003.chds" (other names get ".003" appended)
+std::string dataset_shard_path(const std::string &base_path, int shard);
+
+// One DatasetWriter per shard file. Each producer thread appends to its own
+// shard index, so no lock is taken; a shard must not be shared between
+// threads without external locking
+class ShardedDatasetWriter {
+private:
+    std::vector<std::unique_ptr<DatasetWriter>> shards;
+    std::vector<std::string> paths;
+
+public:
+    ~ShardedDatasetWriter() { close(); }
+
+    bool open(const char *base_path, int shard_count);
+    bool append(int shard, const TrainingRecord *records, size_t n);
+    bool close();
+
+    int get_shard_count() const { return static_cast<int>(shards.size()); }
+    const std::vector<std::string> &get_paths() const { return paths; }
+    uint64_t get_count() const;
+};
+
+// ==================== EXTERNAL SHUFFLE ====================
+
+struct ShuffleOptions {
+    int shard_count = 0;            // 0 = derived from memory_mb
+    uint64_t memory_mb = 512;       // Largest shard held in memory during the second pass
+    uint64_t seed = 0;              // 0 = random seed
+};
+
+struct ShuffleStats {
+    uint64_t records = 0;
+    int shards = 0;
+    double seconds = 0.0;
+    bool ok = false;
+    std::string error;
+};
+
+// Shuffles datasets larger than RAM into one output file: pass 1 scatters
+// every record to a random temporary shard, pass 2 loads each shard, shuffles
+// it in memory and appends it to the output. The result is a uniform
+// permutation of all input records that trainers can read sequentially
+ShuffleStats shuffle_dataset(const std::vector<std::string> &input_paths, const char *output_path,
+                             const ShuffleOptions &options);
+
+// ==================== PGN INGESTION ====================
+
+struct PgnIngestOptions {
+    int threads = 0;                // 0 = hardware concurrency
+    int min_ply = 0;                // Skip positions before this ply
+    int max_ply = 10000;            // Skip positions after this ply (small values build book datasets)
+    bool skip_unfinished = true;    // Drop games without a decisive/draw result ("*")
+    bool sharded = false;           // One output shard per worker thread (see dataset_shard_path)
+};
+
+struct PgnIngestStats {
+    uint64_t games = 0;             // Games whose positions were written
+    uint64_t skipped_games = 0;     // Unfinished games or games with bad FEN / illegal SAN
+    uint64_t positions = 0;         // Records written
+    uint64_t bytes = 0;             // PGN bytes processed
+    double seconds = 0.0;
+    bool ok = false;
+    std::string error;
+    std::vector<std::string> shard_paths;   // Files written when options.sharded is set
+};
+
+// Parses a PGN file in parallel (the file is split into chunks at game
+// boundaries) and writes one TrainingRecord per position before each move
+PgnIngestStats ingest_pgn(const char *pgn_path, const char *dataset_path, const PgnIngestOptions &options);
+
+#endif // DATASET_H
@@ -0,0 +1,102 @@
+#include "dataset_tools.h"
+#include "dataset.h"
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+
+using namespace godot;
+
+void DatasetTools::_bind_methods() {
+    ClassDB::bind_static_method("DatasetTools", D_METHOD("ingest_pgn", "pgn_path", "dataset_path", "options"), &DatasetTools::ingest_pgn, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("DatasetTools", D_METHOD("shuffle_dataset", "input_paths", "output_path", "options"), &DatasetTools::shuffle_dataset, DEFVAL(Dictionary()));
+    ClassDB::bind_static_method("DatasetTools", D_METHOD("get_dataset_info", "path"), &DatasetTools::get_dataset_info);
+}
+
+// res:// and user:// paths are resolved so the files can be opened with stdio
+// (large files are streamed without going through FileAccess)
+static CharString to_native_path(const String &path) {
+    return ProjectSettings::get_singleton()->globalize_path(path).utf8();
+}
+
+Dictionary DatasetTools::ingest_pgn(const String &pgn_path, const String &dataset_path, const Dictionary &options) {
+    PgnIngestOptions ingest_options;
+    ingest_options.threads = options.get("threads", 0);
+    ingest_options.min_ply = options.get("min_ply", 0);
+    ingest_options.max_ply = options.get("max_ply", 10000);
+    ingest_options.skip_unfinished = options.get("skip_unfinished", true);
+    ingest_options.sharded = options.get("sharded", false);
+
+    CharString pgn_native = to_native_path(pgn_path);
+    CharString dataset_native = to_native_path(dataset_path);
+
+    PgnIngestStats stats = ::ingest_pgn(pgn_native.get_data(), dataset_native.get_data(), ingest_options);
+
+    Dictionary result;
+    result["ok"] = stats.ok;
+    result["games"] = (int64_t)stats.games;
+    result["skipped_games"] = (int64_t)stats.skipped_games;
+    result["positions"] = (int64_t)stats.positions;
+    result["seconds"] = stats.seconds;
+    result["games_per_minute"] = stats.seconds > 0.0 ? stats.games * 60.0 / stats.seconds : 0.0;
+    result["error"] = String(stats.error.c_str());
+
+    // Shard paths are native; callers pass them back to shuffle_dataset as-is
+    PackedStringArray shard_paths;
+    for (const std::string &path : stats.shard_paths) {
+        shard_paths.append(String::utf8(path.c_str()));
+    }
+    result["shard_paths"] = shard_paths;
+
+    if (!stats.ok) {
+        UtilityFunctions::print("Error: PGN ingestion failed (", result["error"], "): ", pgn_path);
+    } else {
+        UtilityFunctions::print("Ingested ", result["games"], " games (", result["positions"], " positions) in ",
+                                String::num(stats.seconds, 2), "s -> ", dataset_path);
+    }
+    return result;
+}
+
+Dictionary DatasetTools::shuffle_dataset(const PackedStringArray &input_paths, const String &output_path, const Dictionary &options) {
+    ShuffleOptions shuffle_options;
+    shuffle_options.memory_mb = static_cast<uint64_t>(std::max<int64_t>(1, options.get("memory_mb", 512)));
+    shuffle_options.shard_count = options.get("shards", 0);
+    shuffle_options.seed = static_cast<uint64_t>(static_cast<int64_t>(options.get("seed", 0)));
+
+    std::vector<std::string> inputs;
+    for (int64_t i = 0; i < input_paths.size(); i++) {
+        inputs.push_back(to_native_path(input_paths[i]).get_data());
+    }
+    CharString output_native = to_native_path(output_path);
+
+    ShuffleStats stats = ::shuffle_dataset(inputs, output_native.get_data(), shuffle_options);
+
+    Dictionary result;
+    result["ok"] = stats.ok;
+    result["records"] = (int64_t)stats.records;
+    result["shards"] = stats.shards;
+    result["seconds"] = stats.seconds;
+    result["error"] = String(stats.error.c_str());
+
+    if (!stats.ok) {
+        UtilityFunctions::print("Error: Dataset shuffle failed (", result["error"], "): ", output_path);
+    } else {
+        UtilityFunctions::print("Shuffled ", result["records"], " records through ", stats.shards, " shards in ",
+                                String::num(stats.seconds, 2), "s -> ", output_path);
+    }
+    return result;
+}
+
+Dictionary DatasetTools::get_dataset_info(const String &path) {
+    Dictionary info;
+    DatasetHeader header;
+    CharString native = to_native_path(path);
+
+    bool ok = read_dataset_header(native.get_data(), header);
+    info["ok"] = ok;
+    if (ok) {
+        info["records"] = (int64_t)header.record_count;
+        info["version"] = header.version;
+        info["record_size"] = header.record_size;
+    }
+    return info;
+}
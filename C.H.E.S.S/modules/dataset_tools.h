@@ -0,0 +1,39 @@
+#ifndef DATASET_TOOLS_H
+#define DATASET_TOOLS_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+using namespace godot;
+
+// ==================== DATASET TOOLS ====================
+
+// GDScript entry points for building and inspecting binary training datasets
+// (format described in dataset.h). All methods are static:
+//   DatasetTools.ingest_pgn("user://games.pgn", "user://games.chds", {"threads": 8})
+class DatasetTools : public RefCounted {
+    GDCLASS(DatasetTools, RefCounted)
+
+protected:
+    static void _bind_methods();
+
+public:
+    // Convert a PGN file into a dataset with one record per position
+    // options: threads (0 = all cores), min_ply, max_ply, skip_unfinished,
+    //          sharded (one file per worker thread, written without locking)
+    // Returns {ok, games, skipped_games, positions, seconds, games_per_minute, error, shard_paths}
+    static Dictionary ingest_pgn(const String &pgn_path, const String &dataset_path, const Dictionary &options);
+
+    // Shuffle one or more datasets (larger than RAM) into a single output file
+    // options: memory_mb (default 512), shards (0 = from memory_mb), seed (0 = random)
+    // Returns {ok, records, shards, seconds, error}
+    static Dictionary shuffle_dataset(const PackedStringArray &input_paths, const String &output_path, const Dictionary &options);
+
+    // Header information of a dataset file: {ok, records, version, record_size}
+    static Dictionary get_dataset_info(const String &path);
+};
+
+#endif // DATASET_TOOLS_H
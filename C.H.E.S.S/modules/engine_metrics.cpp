@@ -0,0 +1,137 @@
+#include "engine_metrics.h"
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <chrono>
+
+using namespace godot;
+
+namespace EngineMetrics {
+
+// Define the extern variables
+std::atomic<uint64_t> last_search_nodes{0};
+std::atomic<uint64_t> last_search_usec{0};
+std::atomic<uint32_t> tt_fill_permille{0};
+std::atomic<uint64_t> tt_probes{0};
+std::atomic<uint64_t> tt_hits{0};
+std::atomic<uint64_t> eval_cache_probes{0};
+std::atomic<uint64_t> eval_cache_hits{0};
+std::atomic<uint64_t> nn_evaluations{0};
+std::atomic<uint64_t> training_examples{0};
+std::atomic<float> last_training_loss{0.0f};
+
+// Monitor ids ("category/name" groups them under one heading in the debugger)
+static const char *MONITOR_NPS = "chess_engine/nps";
+static const char *MONITOR_NODES = "chess_engine/nodes_last_search";
+static const char *MONITOR_TT_FILL = "chess_engine/tt_fill_permille";
+static const char *MONITOR_TT_HIT_RATE = "chess_engine/tt_hit_rate";
+static const char *MONITOR_EVAL_CACHE_HIT_RATE = "chess_engine/eval_cache_hit_rate";
+static const char *MONITOR_NN_EVALS = "chess_engine/nn_evals_per_second";
+static const char *MONITOR_TRAIN_RATE = "chess_engine/training_examples_per_second";
+static const char *MONITOR_TRAIN_LOSS = "chess_engine/training_loss";
+
+// Turns a cumulative counter into a per-second rate between two polls
+// Monitors are only polled from the main thread, so no locking is needed here
+class RateSampler {
+private:
+    uint64_t last_count;
+    std::chrono::steady_clock::time_point last_time;
+    double last_rate;
+
+public:
+    RateSampler() : last_count(0), last_time(std::chrono::steady_clock::now()), last_rate(0.0) {}
+
+    double sample(uint64_t count) {
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - last_time).count();
+
+        // Keep the previous value if polled twice within the same frame
+        if (elapsed < 0.05) return last_rate;
+
+        last_rate = static_cast<double>(count - last_count) / elapsed;
+        last_count = count;
+        last_time = now;
+        return last_rate;
+    }
+};
+
+static RateSampler nn_eval_sampler;
+static RateSampler training_sampler;
+
+void record_search(uint64_t nodes, uint64_t usec, uint32_t fill_permille) {
+    last_search_nodes.store(nodes, std::memory_order_relaxed);
+    last_search_usec.store(usec, std::memory_order_relaxed);
+    tt_fill_permille.store(fill_permille, std::memory_order_relaxed);
+}
+
+// ==================== MONITOR CALLBACKS ====================
+
+double get_nps() {
+    uint64_t usec = last_search_usec.load(std::memory_order_relaxed);
+    if (usec == 0) return 0.0;
+    return static_cast<double>(last_search_nodes.load(std::memory_order_relaxed)) * 1000000.0 / usec;
+}
+
+double get_last_search_nodes() {
+    return static_cast<double>(last_search_nodes.load(std::memory_order_relaxed));
+}
+
+double get_tt_fill_permille() {
+    return static_cast<double>(tt_fill_permille.load(std::memory_order_relaxed));
+}
+
+double get_tt_hit_rate() {
+    uint64_t probes = tt_probes.load(std::memory_order_relaxed);
+    if (probes == 0) return 0.0;
+    return static_cast<double>(tt_hits.load(std::memory_order_relaxed)) / probes;
+}
+
+double get_eval_cache_hit_rate() {
+    uint64_t probes = eval_cache_probes.load(std::memory_order_relaxed);
+    if (probes == 0) return 0.0;
+    return static_cast<double>(eval_cache_hits.load(std::memory_order_relaxed)) / probes;
+}
+
+double get_nn_evals_per_second() {
+    return nn_eval_sampler.sample(nn_evaluations.load(std::memory_order_relaxed));
+}
+
+double get_training_examples_per_second() {
+    return training_sampler.sample(training_examples.load(std::memory_order_relaxed));
+}
+
+double get_training_loss() {
+    return static_cast<double>(last_training_loss.load(std::memory_order_relaxed));
+}
+
+// ==================== REGISTRATION ====================
+
+void register_monitors() {
+    Performance *performance = Performance::get_singleton();
+    if (!performance) return;
+
+    performance->add_custom_monitor(MONITOR_NPS, callable_mp_static(&get_nps));
+    performance->add_custom_monitor(MONITOR_NODES, callable_mp_static(&get_last_search_nodes));
+    performance->add_custom_monitor(MONITOR_TT_FILL, callable_mp_static(&get_tt_fill_permille));
+    performance->add_custom_monitor(MONITOR_TT_HIT_RATE, callable_mp_static(&get_tt_hit_rate));
+    performance->add_custom_monitor(MONITOR_EVAL_CACHE_HIT_RATE, callable_mp_static(&get_eval_cache_hit_rate));
+    performance->add_custom_monitor(MONITOR_NN_EVALS, callable_mp_static(&get_nn_evals_per_second));
+    performance->add_custom_monitor(MONITOR_TRAIN_RATE, callable_mp_static(&get_training_examples_per_second));
+    performance->add_custom_monitor(MONITOR_TRAIN_LOSS, callable_mp_static(&get_training_loss));
+}
+
+void unregister_monitors() {
+    Performance *performance = Performance::get_singleton();
+    if (!performance) return;
+
+    const char *monitors[] = {
+        MONITOR_NPS, MONITOR_NODES, MONITOR_TT_FILL, MONITOR_TT_HIT_RATE, MONITOR_EVAL_CACHE_HIT_RATE,
+        MONITOR_NN_EVALS, MONITOR_TRAIN_RATE, MONITOR_TRAIN_LOSS
+    };
+    for (const char *id : monitors) {
+        if (performance->has_custom_monitor(id)) {
+            performance->remove_custom_monitor(id);
+        }
+    }
+}
+
+} // namespace EngineMetrics
@@ -0,0 +1,57 @@
+#ifndef ENGINE_METRICS_H
+#define ENGINE_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+
+// Engine-wide throughput counters
+// Updated by every Agent / NeuralNet instance and exposed to the editor debugger
+// and in-game telemetry as custom monitors of Godot's Performance singleton
+namespace EngineMetrics {
+
+// ==================== SEARCH ====================
+// Published once per completed search (run_iterative_deepening / get_best_move)
+extern std::atomic<uint64_t> last_search_nodes;
+extern std::atomic<uint64_t> last_search_usec;
+extern std::atomic<uint32_t> tt_fill_permille;
+
+// Transposition table probe statistics (cumulative)
+extern std::atomic<uint64_t> tt_probes;
+extern std::atomic<uint64_t> tt_hits;
+
+// Persistent EvalCache lookup statistics (cumulative, across cache files)
+extern std::atomic<uint64_t> eval_cache_probes;
+extern std::atomic<uint64_t> eval_cache_hits;
+
+// ==================== NEURAL NETWORK ====================
+// Cumulative counters, converted to per-second rates when the monitors are polled
+extern std::atomic<uint64_t> nn_evaluations;
+extern std::atomic<uint64_t> training_examples;
+extern std::atomic<float> last_training_loss;
+
+// Record a finished search
+void record_search(uint64_t nodes, uint64_t usec, uint32_t fill_permille);
+
+// Record a finished training step
+inline void record_training(uint64_t examples, float loss) {
+    training_examples.fetch_add(examples, std::memory_order_relaxed);
+    last_training_loss.store(loss, std::memory_order_relaxed);
+}
+
+// ==================== MONITOR CALLBACKS ====================
+double get_nps();
+double get_last_search_nodes();
+double get_tt_fill_permille();
+double get_tt_hit_rate();
+double get_eval_cache_hit_rate();
+double get_nn_evals_per_second();
+double get_training_examples_per_second();
+double get_training_loss();
+
+// Register / unregister the custom monitors (called from register_types.cpp)
+void register_monitors();
+void unregister_monitors();
+
+} // namespace EngineMetrics
+
+#endif // ENGINE_METRICS_H
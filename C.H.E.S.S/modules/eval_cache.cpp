@@ -0,0 +1,187 @@
+#include "eval_cache.h"
+#include "engine_metrics.h"
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#define eval_cache_fseek _fseeki64
+#define eval_cache_ftell _ftelli64
+#else
+#define eval_cache_fseek fseeko
+#define eval_cache_ftell ftello
+#endif
+
+// Smallest index (slots); it doubles whenever it gets half full
+static const uint64_t MIN_INDEX_SLOTS = 1024;
+
+EvalCache::EvalCache()
+    : mapped_records(nullptr), mapped_count(0), log(nullptr), slot_mask(0), hits(0), misses(0) {}
+
+// ==================== INDEX ====================
+
+uint64_t EvalCache::slot_key(uint64_t hash, uint32_t model_checksum, int depth, uint8_t kind) {
+    uint64_t extra = (static_cast<uint64_t>(model_checksum) << 16) |
+                     (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 8) | kind;
+    return hash ^ (extra * 0x9E3779B97F4A7C15ULL);
+}
+
+const EvalCacheRecord &EvalCache::record_at(uint64_t number) const {
+    return number < mapped_count ? mapped_records[number] : appended[number - mapped_count];
+}
+
+void EvalCache::index_record(uint64_t number) {
+    const EvalCacheRecord &record = record_at(number);
+    uint64_t slot = slot_key(record.hash, record.model_checksum, record.depth, record.kind) & slot_mask;
+    while (slots[slot] != 0) {
+        slot = (slot + 1) & slot_mask;
+    }
+    slots[slot] = static_cast<uint32_t>(number + 1);
+}
+
+void EvalCache::grow_index() {
+    uint64_t count = mapped_count + appended.size();
+    uint64_t capacity = MIN_INDEX_SLOTS;
+    while (capacity < count * 2) capacity *= 2;
+    if (capacity <= slots.size()) return;
+
+    slots.assign(capacity, 0);
+    slot_mask = capacity - 1;
+    for (uint64_t i = 0; i < count; i++) {
+        index_record(i);
+    }
+}
+
+// ==================== OPEN / CLOSE ====================
+
+bool EvalCache::open(const char *path) {
+    close();
+
+    // A missing or empty file starts a new log; anything else must be a valid one
+    int64_t existing_size = 0;
+    if (FILE *probe = fopen(path, "rb")) {
+        eval_cache_fseek(probe, 0, SEEK_END);
+        existing_size = eval_cache_ftell(probe);
+        fclose(probe);
+    }
+
+    if (existing_size > 0) {
+        if (!mapped.open(path) || mapped.size() < sizeof(EvalCacheHeader)) {
+            mapped.close();
+            return false;
+        }
+
+        EvalCacheHeader header;
+        memcpy(&header, mapped.data(), sizeof(header));
+        if (memcmp(header.magic, EVAL_CACHE_MAGIC, 4) != 0 ||
+            header.version != EVAL_CACHE_VERSION ||
+            header.record_size != sizeof(EvalCacheRecord)) {
+            mapped.close();
+            return false;
+        }
+
+        // A partially written trailing record (crash during append) is ignored
+        // and overwritten by the next insert
+        mapped_count = (mapped.size() - sizeof(header)) / sizeof(EvalCacheRecord);
+        mapped_records = reinterpret_cast<const EvalCacheRecord *>(mapped.data() + sizeof(header));
+
+        log = fopen(path, "r+b");
+        if (!log || eval_cache_fseek(log, sizeof(header) + mapped_count * sizeof(EvalCacheRecord), SEEK_SET) != 0) {
+            close();
+            return false;
+        }
+    } else {
+        log = fopen(path, "wb");
+        if (!log) return false;
+
+        EvalCacheHeader header;
+        memcpy(header.magic, EVAL_CACHE_MAGIC, 4);
+        header.version = EVAL_CACHE_VERSION;
+        header.record_size = sizeof(EvalCacheRecord);
+        header.reserved = 0;
+        if (fwrite(&header, sizeof(header), 1, log) != 1) {
+            close();
+            return false;
+        }
+    }
+
+    grow_index();
+    return true;
+}
+
+void EvalCache::close() {
+    std::unique_lock<std::shared_mutex> guard(lock);
+
+    if (log) {
+        fclose(log);
+        log = nullptr;
+    }
+    mapped.close();
+    mapped_records = nullptr;
+    mapped_count = 0;
+    appended.clear();
+    appended.shrink_to_fit();
+    slots.clear();
+    slots.shrink_to_fit();
+    slot_mask = 0;
+    hits.store(0, std::memory_order_relaxed);
+    misses.store(0, std::memory_order_relaxed);
+}
+
+void EvalCache::flush() {
+    std::unique_lock<std::shared_mutex> guard(lock);
+    if (log) fflush(log);
+}
+
+// ==================== LOOKUP / INSERT ====================
+
+bool EvalCache::lookup(uint64_t hash, uint32_t model_checksum, int depth, uint8_t kind, EvalCacheRecord &out) const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    if (slots.empty()) return false;
+
+    EngineMetrics::eval_cache_probes.fetch_add(1, std::memory_order_relaxed);
+    uint64_t slot = slot_key(hash, model_checksum, depth, kind) & slot_mask;
+    while (slots[slot] != 0) {
+        const EvalCacheRecord &record = record_at(slots[slot] - 1);
+        if (record.hash == hash && record.model_checksum == model_checksum &&
+            record.depth == depth && record.kind == kind) {
+            out = record;
+            hits.fetch_add(1, std::memory_order_relaxed);
+            EngineMetrics::eval_cache_hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        slot = (slot + 1) & slot_mask;
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void EvalCache::insert(const EvalCacheRecord &record) {
+    std::unique_lock<std::shared_mutex> guard(lock);
+    if (!log) return;
+
+    uint64_t slot = slot_key(record.hash, record.model_checksum, record.depth, record.kind) & slot_mask;
+    while (slots[slot] != 0) {
+        const EvalCacheRecord &existing = record_at(slots[slot] - 1);
+        if (existing.hash == record.hash && existing.model_checksum == record.model_checksum &&
+            existing.depth == record.depth && existing.kind == record.kind) {
+            return;
+        }
+        slot = (slot + 1) & slot_mask;
+    }
+
+    if (fwrite(&record, sizeof(record), 1, log) != 1) return;
+
+    appended.push_back(record);
+    uint64_t number = mapped_count + appended.size() - 1;
+    if ((number + 1) * 2 > slots.size()) {
+        grow_index();
+    } else {
+        slots[slot] = static_cast<uint32_t>(number + 1);
+    }
+}
+
+uint64_t EvalCache::get_count() const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return mapped_count + appended.size();
+}
@@ -0,0 +1,107 @@
+#ifndef EVAL_CACHE_H
+#define EVAL_CACHE_H
+
+#include "mapped_file.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// Persistent evaluation / search-result cache (Godot-free)
+//
+// Results are keyed by (Zobrist hash, model checksum, depth, kind) and kept in
+// an append-only log file: a small header followed by fixed-size records.
+// Opening a cache maps the existing log read-only and indexes it with an
+// open-addressing hash table; new results are indexed in memory and appended
+// to the log, so a crash at worst loses the unflushed tail.
+//
+// Lookups take a shared lock and may run from any number of threads; inserts
+// take the lock exclusively.
+
+#define EVAL_CACHE_MAGIC "CHEC"
+#define EVAL_CACHE_VERSION 2     // 2: search results keyed by search variant, PV records
+
+// What a record holds (part of the key). Search kinds are offset by the search
+// variant (driver and options), so each variant only sees its own results
+#define EVAL_CACHE_EVAL_WHITE 0     // Static evaluation from white's perspective
+#define EVAL_CACHE_EVAL_BLACK 1     // Static evaluation from black's (mirrored) perspective
+#define EVAL_CACHE_SEARCH     2     // Root search result (score is white's point of view)
+#define EVAL_CACHE_PV         64    // Principal variation of a root search result, see below
+
+// PV records: chunk i of the PV of a search result is keyed by the result's
+// hash XOR (i + 1) * EVAL_CACHE_PV_SALT, with the same depth. score and reserved
+// each pack two moves of 16 bits (from | to << 6 | promotion piece << 12); a
+// zero move ends the PV
+#define EVAL_CACHE_PV_SALT          0x9E3779B97F4A7C15ull
+#define EVAL_CACHE_PV_MOVES_PER_RECORD 4
+
+struct EvalCacheRecord {
+    uint64_t hash;              // Zobrist hash of the position
+    uint32_t model_checksum;    // Evaluator identity, 0 = material evaluation
+    int32_t score;
+    int8_t depth;               // Search depth, 0 for static evaluations
+    uint8_t kind;               // EVAL_CACHE_*
+    uint8_t best_from;          // Best move for search results, 255 otherwise
+    uint8_t best_to;
+    uint32_t reserved;
+};
+
+struct EvalCacheHeader {
+    char magic[4];              // EVAL_CACHE_MAGIC
+    uint32_t version;           // EVAL_CACHE_VERSION
+    uint32_t record_size;       // sizeof(EvalCacheRecord)
+    uint32_t reserved;
+};
+
+static_assert(sizeof(EvalCacheRecord) == 24, "EvalCacheRecord layout changed");
+static_assert(sizeof(EvalCacheHeader) == 16, "EvalCacheHeader layout changed");
+
+class EvalCache {
+private:
+    MappedFile mapped;                      // Records already on disk when opened
+    const EvalCacheRecord *mapped_records;
+    uint64_t mapped_count;
+    std::vector<EvalCacheRecord> appended;  // Records added since open
+    FILE *log;
+
+    // Open-addressing index: slot -> record number + 1 (0 = empty)
+    std::vector<uint32_t> slots;
+    uint64_t slot_mask;
+
+    mutable std::shared_mutex lock;
+    mutable std::atomic<uint64_t> hits;
+    mutable std::atomic<uint64_t> misses;
+
+    static uint64_t slot_key(uint64_t hash, uint32_t model_checksum, int depth, uint8_t kind);
+    const EvalCacheRecord &record_at(uint64_t number) const;
+    void index_record(uint64_t number);
+    void grow_index();
+
+public:
+    EvalCache();
+    ~EvalCache() { close(); }
+
+    EvalCache(const EvalCache &) = delete;
+    EvalCache &operator=(const EvalCache &) = delete;
+
+    // Opens (or creates) the log at path. Fails on a foreign or incompatible file
+    bool open(const char *path);
+    void close();
+    void flush();
+
+    bool is_open() const { return log != nullptr; }
+
+    // Returns true and fills out if the exact key is cached
+    bool lookup(uint64_t hash, uint32_t model_checksum, int depth, uint8_t kind, EvalCacheRecord &out) const;
+
+    // Adds a result (ignored if the key is already cached)
+    void insert(const EvalCacheRecord &record);
+
+    uint64_t get_count() const;
+    uint64_t get_hits() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t get_misses() const { return misses.load(std::memory_order_relaxed); }
+};
+
+#endif // EVAL_CACHE_H
@@ -0,0 +1,35 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Read-only memory mapping of a whole file (Godot-free)
+// Large binary files (saved hash tables, datasets) are read straight from the
+// page cache instead of being copied through a stdio buffer first.
+class MappedFile {
+private:
+    const uint8_t *mapped;
+    size_t mapped_size;
+#ifdef _WIN32
+    void *file_handle;
+    void *mapping_handle;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Maps path read-only. Fails on a missing or empty file
+    bool open(const char *path);
+    void close();
+
+    bool is_open() const { return mapped != nullptr; }
+    const uint8_t *data() const { return mapped; }
+    size_t size() const { return mapped_size; }
+};
+
+#endif // MAPPED_FILE_H
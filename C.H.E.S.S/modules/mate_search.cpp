@@ -0,0 +1,298 @@
+#include "mate_search.h"
+#include <algorithm>
+
+MateSearch::MateSearch(int table_bits) {
+    table_bits = std::max(10, std::min(table_bits, 28));
+    table.assign(size_t(1) << table_bits, Entry{0, {0, 0, 0, 0}});
+    table_mask = table.size() - 1;
+    nodes = 0;
+    max_nodes = 0;
+    node_budget = 0;
+    max_plies = MATE_SEARCH_DEFAULT_PLIES;
+}
+
+// ==================== TABLE ====================
+
+bool MateSearch::lookup(uint64_t key, NodeValues &values) const {
+    const Entry &entry = table[key & table_mask];
+    if (entry.key != key) return false;
+    values = entry.values;
+    return true;
+}
+
+void MateSearch::store(uint64_t key, const NodeValues &values) {
+    table[key & table_mask] = Entry{key, values};
+}
+
+// ==================== NODE VALUES ====================
+
+// A draw is a win for the defender: proven for it, disproven for the attacker
+static inline void draw_values(bool attacker_to_move, uint32_t &phi, uint32_t &delta) {
+    phi = attacker_to_move ? MATE_SEARCH_INFINITY : 0;
+    delta = attacker_to_move ? 0 : MATE_SEARCH_INFINITY;
+}
+
+// Proof number sums: transpositions count the same subtree more than once, so
+// large sums must not reach the infinity that marks a proof or disproof
+static inline uint32_t add_proof_numbers(uint32_t sum, uint32_t value) {
+    if (sum == MATE_SEARCH_INFINITY || value == MATE_SEARCH_INFINITY) return MATE_SEARCH_INFINITY;
+    return std::min(MATE_SEARCH_INFINITY - 1, sum + value);
+}
+
+bool MateSearch::child_values(const Position &child, int ply, bool fresh, NodeValues &values) const {
+    // Children alternate roles: the attacker moves on even plies
+    const bool attacker_to_move = (ply % 2) == 0;
+    const uint64_t key = child.get_hash();
+
+    // Repeated on the current line: a draw that holds on this path only
+    if (std::find(path.begin(), path.end(), key) != path.end()) {
+        draw_values(attacker_to_move, values.phi, values.delta);
+        values.distance = 0;
+        values.horizon = 0;
+        return true;
+    }
+    if (lookup(key, values)) {
+        const bool refuted = attacker_to_move ? values.delta == 0 : values.phi == 0;
+        if (fresh || !refuted || values.horizon >= static_cast<uint32_t>(max_plies - ply)) return true;
+    }
+    values = NodeValues{1, 1, 0, 0};
+    return false;
+}
+
+bool MateSearch::terminal_values(const Position &pos, bool attacker_to_move, int ply, const MoveList &moves, NodeValues &values) const {
+    // Mate is distance 0, anything else carries none
+    values.distance = 0;
+    values.horizon = MATE_SEARCH_INFINITY;
+    if (moves.count == 0) {
+        if (pos.is_king_in_check(pos.turn)) {
+            // The side to move is mated
+            values.phi = MATE_SEARCH_INFINITY;
+            values.delta = 0;
+        } else {
+            draw_values(attacker_to_move, values.phi, values.delta);
+        }
+        return true;
+    }
+
+    if (pos.halfmove_clock >= 100 || pos.is_insufficient_material()) {
+        draw_values(attacker_to_move, values.phi, values.delta);
+        return true;
+    }
+    if (ply >= max_plies) {
+        draw_values(attacker_to_move, values.phi, values.delta);
+        values.horizon = 0;
+        return true;
+    }
+
+    return false;
+}
+
+// ==================== DF-PN ====================
+
+MateSearch::NodeValues MateSearch::expand(const Position &pos, bool attacker_to_move, int ply, uint32_t th_phi, uint32_t th_delta) {
+    nodes++;
+    const uint64_t key = pos.get_hash();
+
+    MoveList moves;
+    Position scratch = pos;
+    scratch.generate_legal_moves(moves);
+
+    NodeValues result;
+    if (terminal_values(pos, attacker_to_move, ply, moves, result)) {
+        store(key, result);
+        return result;
+    }
+
+    std::vector<Position> children;
+    children.reserve(moves.count);
+    for (int i = 0; i < moves.count; i++) {
+        children.push_back(pos.after(moves.moves[i]));
+    }
+
+    // Children expanded from here keep the values their expansion returned (they
+    // hold for this path, whatever their horizon, and survive a table collision
+    // with a sibling). The others are read again each round, for transpositions
+    std::vector<NodeValues> values(children.size(), NodeValues{1, 1, 0, 0});
+    std::vector<bool> fresh(children.size(), false);
+
+    uint32_t shortest_mate = MATE_SEARCH_INFINITY;      // Over children where the defender is mated
+    uint32_t longest_mate = 0;                          // Over all children
+    uint32_t shortest_horizon = MATE_SEARCH_INFINITY;   // Over all children
+    uint32_t longest_horizon = 0;                       // Over refuted children
+
+    path.push_back(key);
+    while (true) {
+        // phi = min over children of their delta, delta = sum of their phi
+        uint32_t min_delta = MATE_SEARCH_INFINITY;
+        uint32_t second_delta = MATE_SEARCH_INFINITY;
+        uint32_t sum_phi = 0;
+        uint32_t best_phi = MATE_SEARCH_INFINITY;
+        int best = 0;
+        shortest_mate = MATE_SEARCH_INFINITY;
+        longest_mate = 0;
+        shortest_horizon = MATE_SEARCH_INFINITY;
+        longest_horizon = 0;
+
+        for (size_t i = 0; i < children.size(); i++) {
+            NodeValues child;
+            if (!fresh[i] && child_values(children[i], ply + 1, false, child)) values[i] = child;
+            child = values[i];
+
+            sum_phi = add_proof_numbers(sum_phi, child.phi);
+            if (child.delta < min_delta) {
+                second_delta = min_delta;
+                min_delta = child.delta;
+                best_phi = child.phi;
+                best = static_cast<int>(i);
+            } else if (child.delta < second_delta) {
+                second_delta = child.delta;
+            }
+
+            if (child.delta == 0) shortest_mate = std::min(shortest_mate, child.distance);
+            longest_mate = std::max(longest_mate, child.distance);
+            shortest_horizon = std::min(shortest_horizon, child.horizon);
+            if (child.delta == 0) longest_horizon = std::max(longest_horizon, child.horizon);
+        }
+
+        result.phi = min_delta;
+        result.delta = sum_phi;
+        if (result.phi >= th_phi || result.delta >= th_delta || nodes >= max_nodes) break;
+
+        // The most proving child gets as much effort as keeps it the best choice
+        const uint32_t child_th_phi = std::min(MATE_SEARCH_INFINITY, th_delta - result.delta + best_phi);
+        // 1+epsilon trick: a margin over the second best child keeps the search
+        // from switching back and forth between two close ones
+        const uint32_t second_margin = second_delta + second_delta / MATE_SEARCH_EPSILON_DIVISOR + 1;
+        const uint32_t child_th_delta = std::min(th_phi, std::min(MATE_SEARCH_INFINITY, second_margin));
+        values[best] = expand(children[best], !attacker_to_move, ply + 1, child_th_phi, child_th_delta);
+        fresh[best] = true;
+    }
+    path.pop_back();
+
+    // Attacker proven: quickest mating move. Defender proven lost: every reply
+    // mates, the longest one counts
+    result.distance = 0;
+    if (attacker_to_move && result.phi == 0) result.distance = shortest_mate + 1;
+    if (!attacker_to_move && result.delta == 0) result.distance = longest_mate + 1;
+
+    // A refutation holds as far as the children it rests on: all of them for
+    // the attacker, the best refuting one for the defender
+    const bool refuted = attacker_to_move ? result.delta == 0 : result.phi == 0;
+    result.horizon = static_cast<uint32_t>(max_plies - ply);
+    if (refuted) {
+        const uint32_t child_horizon = attacker_to_move ? shortest_horizon : longest_horizon;
+        result.horizon = (child_horizon == MATE_SEARCH_INFINITY) ? MATE_SEARCH_INFINITY : child_horizon + 1;
+    }
+    store(key, result);
+    return result;
+}
+
+bool MateSearch::prove(const Position &pos, bool attacker_to_move, int ply, NodeValues &values) {
+    // Proven for the attacker: won with the attacker to move, lost with the defender to move
+    auto proven = [&]() { return attacker_to_move ? values.phi == 0 : values.delta == 0; };
+    if (lookup(pos.get_hash(), values) && proven()) return true;
+
+    // Entry overwritten since: search this node again, out of what is left of the budget
+    if (nodes >= max_nodes) return false;
+    values = expand(pos, attacker_to_move, ply, MATE_SEARCH_INFINITY, MATE_SEARCH_INFINITY);
+    return proven();
+}
+
+bool MateSearch::extract_line(const Position &root, uint32_t distance, std::vector<FastMove> &line) {
+    Position pos = root;
+    bool attacker_to_move = true;
+    path.clear();
+
+    // Proofs reused through transpositions may run past max_plies, never past distance
+    for (int ply = 0; ply <= static_cast<int>(distance); ply++) {
+        NodeValues values;
+        if (!prove(pos, attacker_to_move, ply, values)) return false;
+
+        MoveList moves;
+        Position scratch = pos;
+        scratch.generate_legal_moves(moves);
+        if (moves.count == 0) return true;  // Mated
+
+        // Attacker: the proven move with the shortest mate. Defender: every
+        // reply is lost, take the longest. Children whose entries were
+        // overwritten are proven again (the attacker only needs one)
+        path.push_back(pos.get_hash());
+        int chosen = -1;
+        uint32_t chosen_distance = 0;
+        for (int pass = 0; pass < 2 && chosen < 0; pass++) {
+            for (int i = 0; i < moves.count; i++) {
+                const Position child = pos.after(moves.moves[i]);
+                child_values(child, ply + 1, true, values);
+                bool mates = attacker_to_move ? values.delta == 0 : values.phi == 0;
+
+                if (!mates && (pass == 1 || !attacker_to_move)) {
+                    if (!prove(child, !attacker_to_move, ply + 1, values)) continue;
+                    mates = true;
+                }
+                if (!mates) continue;
+
+                const bool better = attacker_to_move ? values.distance < chosen_distance : values.distance > chosen_distance;
+                if (chosen < 0 || better) {
+                    chosen = i;
+                    chosen_distance = values.distance;
+                }
+                if (pass == 1) break;
+            }
+        }
+        if (chosen < 0) return false;
+
+        line.push_back(moves.moves[chosen]);
+        pos = pos.after(moves.moves[chosen]);
+        attacker_to_move = !attacker_to_move;
+    }
+    return false;
+}
+
+MateSearchStatus MateSearch::run(const Position &root, int plies, std::vector<FastMove> &line) {
+    std::fill(table.begin(), table.end(), Entry{0, {0, 0, 0, 0}});
+    path.clear();
+    line.clear();
+    max_nodes = node_budget;
+    max_plies = plies;
+
+    const NodeValues values = expand(root, true, 0, MATE_SEARCH_INFINITY, MATE_SEARCH_INFINITY);
+    if (values.phi == 0) {
+        // A line that could not be rebuilt within the budget is not reported
+        if (!extract_line(root, values.distance, line)) line.clear();
+        return MATE_SEARCH_PROVEN;
+    }
+    return (values.delta == 0) ? MATE_SEARCH_DISPROVEN : MATE_SEARCH_UNPROVEN;
+}
+
+MateSearchResult MateSearch::search(const Position &root, uint64_t p_max_nodes, int p_max_plies) {
+    MateSearchResult result;
+    nodes = 0;
+    node_budget = std::max<uint64_t>(p_max_nodes, 1);
+
+    result.status = run(root, std::max(1, p_max_plies), result.line);
+
+    // Tighten the ply limit below the mate found until no shorter one is proven.
+    // Mates end on an attacker move, so lines are an odd number of plies. A pass
+    // may prove a mate it cannot rebuild, or a longer one through transpositions
+    std::vector<FastMove> shorter;
+    int limit = static_cast<int>(result.line.size()) - 2;
+    while (result.status == MATE_SEARCH_PROVEN && !result.line.empty() && nodes < node_budget) {
+        if (limit < 1) {
+            result.shortest = result.line.size() == 1;
+            break;
+        }
+
+        const MateSearchStatus status = run(root, limit, shorter);
+        if (status == MATE_SEARCH_DISPROVEN) {
+            result.shortest = static_cast<int>(result.line.size()) == limit + 2;
+            break;
+        }
+        if (status != MATE_SEARCH_PROVEN) break;
+
+        if (!shorter.empty() && shorter.size() < result.line.size()) result.line.swap(shorter);
+        limit = std::min(limit, static_cast<int>(result.line.size())) - 2;
+    }
+
+    result.nodes = nodes;
+    return result;
+}
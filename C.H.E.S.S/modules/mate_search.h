@@ -0,0 +1,103 @@
+#ifndef MATE_SEARCH_H
+#define MATE_SEARCH_H
+
+#include "position.h"
+#include <cstdint>
+#include <vector>
+
+// Forced-mate prover (Godot-free): depth-first proof-number search (df-pn)
+//
+// The side to move at the root is the attacker; a position is proven when
+// every defence is mated. Unlike alpha-beta, df-pn grows the tree towards the
+// least-resisting lines (few defender replies, forcing attacker moves), so
+// long forced mates are proven in far fewer nodes than a full-width search of
+// the same length. Draws (stalemate, dead material, positions repeated on the
+// current line, lines longer than max_plies) count as refutations. Once the
+// root is proven, the search is repeated with max_plies just below the mate
+// found, until no shorter mate is proven or the node budget runs out.
+//
+// Proof and disproof numbers live in a table of its own (not the search TT),
+// stored from the perspective of the side to move: phi is the proof number
+// of "the side to move wins", delta its disproof number. Sums saturate one
+// below MATE_SEARCH_INFINITY, which only a proof or disproof may set. Proven
+// mates also keep their distance: plies to mate with the quickest attack
+// found and the longest defence within the proof.
+//
+// Refutations that rest on the ply limit or on a repetition of the current
+// line only hold where as many plies are left (a repetition: none), so they
+// are not reused from shallower nodes elsewhere in the tree.
+
+#define MATE_SEARCH_INFINITY        0x3FFFFFFFu
+#define MATE_SEARCH_DEFAULT_PLIES   63      // Longest line considered (mate in 32)
+#define MATE_SEARCH_EPSILON_DIVISOR 4       // Child disproof threshold: second best * (1 + 1/4)
+
+enum MateSearchStatus {
+    MATE_SEARCH_PROVEN,         // Forced mate found, line holds it
+    MATE_SEARCH_DISPROVEN,      // No forced mate within max_plies
+    MATE_SEARCH_UNPROVEN        // Node budget ran out first
+};
+
+struct MateSearchResult {
+    MateSearchStatus status = MATE_SEARCH_UNPROVEN;
+    std::vector<FastMove> line;     // Attacker and defender moves ending in mate, empty if not rebuilt
+    bool shortest = false;          // No shorter mate: a search limited to fewer plies was disproven
+    uint64_t nodes = 0;             // Nodes expanded, over all passes
+};
+
+class MateSearch {
+private:
+    // Values of one node, from the perspective of its side to move
+    struct NodeValues {
+        uint32_t phi;
+        uint32_t delta;
+        uint32_t distance;          // Plies to mate when the attacker is proven to mate from here
+        uint32_t horizon;           // Plies left before max_plies when found: a refutation
+                                    // may only rest on the ply limit, so it holds no further
+    };
+
+    struct Entry {
+        uint64_t key;
+        NodeValues values;
+    };
+
+    std::vector<Entry> table;       // Always-replace, indexed by hash
+    uint64_t table_mask;
+    std::vector<uint64_t> path;     // Hashes of the positions on the current line
+    uint64_t nodes;
+    uint64_t max_nodes;             // Stop expanding at this node count
+    uint64_t node_budget;           // Over all passes, line extraction included
+    int max_plies;
+
+    bool lookup(uint64_t key, NodeValues &values) const;
+    void store(uint64_t key, const NodeValues &values);
+
+    // Values of a child; false (and 1/1) if it has none yet, or only a refutation
+    // found with fewer plies left than the child has now (unless fresh)
+    bool child_values(const Position &child, int ply, bool fresh, NodeValues &values) const;
+
+    // Terminal positions: true and the values if pos needs no expansion
+    bool terminal_values(const Position &pos, bool attacker_to_move, int ply, const MoveList &moves, NodeValues &values) const;
+
+    // Multiple iterative deepening: expand pos until phi >= th_phi or delta >= th_delta.
+    // Returns the values it stored. Children expanded from here keep theirs in a
+    // local array, so table collisions between siblings cannot undo their work
+    NodeValues expand(const Position &pos, bool attacker_to_move, int ply, uint32_t th_phi, uint32_t th_delta);
+
+    // Proof of pos, searching again (within node_budget) where entries were overwritten
+    bool prove(const Position &pos, bool attacker_to_move, int ply, NodeValues &values);
+
+    // Attacker: the proven move with the shortest mate. Defender: the reply with the longest
+    // False if the line does not reach mate (a re-search ran out of nodes)
+    bool extract_line(const Position &root, uint32_t distance, std::vector<FastMove> &line);
+
+    // One df-pn pass from an empty table with the given ply limit; the line if proven
+    MateSearchStatus run(const Position &root, int plies, std::vector<FastMove> &line);
+
+public:
+    // table_bits: log2 of the table entries (24 bytes each)
+    explicit MateSearch(int table_bits = 20);
+
+    MateSearchResult search(const Position &root, uint64_t max_nodes, int max_plies = MATE_SEARCH_DEFAULT_PLIES);
+};
+
+#endif // MATE_SEARCH_H
@@ -1,8 +1,24 @@
 #include "neural_network.h"
+#include "dataset.h"
+#include "engine_metrics.h"
+#include "nn_features.h"
+#include "trace.h"
+#include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <cmath>
+#include <filesystem>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace godot;
 
@@ -144,6 +160,8 @@ float NeuralNet::forward_pass(const std::vector<float> &input_features) {
         }
     }
 
+    EngineMetrics::nn_evaluations.fetch_add(1, std::memory_order_relaxed);
+
     // Set input layer activations
     for (size_t i = 0; i < input_features.size(); i++) {
         activations[0][i] = input_features[i];
@@ -200,6 +218,48 @@ float NeuralNet::forward_pass(const std::vector<float> &input_features) {
     return 0.5f;  // Should never reach here
 }
 
+void NeuralNet::forward_batch(const float *inputs, size_t count, std::vector<float> &scratch, float *outputs) const {
+    int widest = 0;
+    for (int size : layer_sizes) widest = std::max(widest, size);
+    scratch.resize(2 * count * static_cast<size_t>(widest));
+
+    // Layer outputs ping-pong between the two halves of scratch
+    const float *in = inputs;
+    float *out = scratch.data();
+    size_t num_layers = layer_sizes.size();
+
+    for (size_t layer = 1; layer < num_layers; layer++) {
+        const int prev_layer_size = layer_sizes[layer - 1];
+        const int current_layer_size = layer_sizes[layer];
+        const size_t weight_idx = layer - 1;
+        const bool output_layer = (layer == num_layers - 1);
+        const int activation_type = output_layer ? 2 :
+                                    (layer - 1 < activation_functions.size() ? activation_functions[layer - 1] : 2);
+
+        for (int neuron = 0; neuron < current_layer_size; neuron++) {
+            const float* neuron_weights = weights[weight_idx][neuron].data();
+            const float bias = biases[weight_idx][neuron];
+
+            for (size_t row = 0; row < count; row++) {
+                const float* prev_activations = in + row * prev_layer_size;
+                float sum = bias;
+                for (int prev_neuron = 0; prev_neuron < prev_layer_size; prev_neuron++) {
+                    sum += prev_activations[prev_neuron] * neuron_weights[prev_neuron];
+                }
+                out[row * current_layer_size + neuron] = activate(activation_type, sum);
+            }
+        }
+
+        in = out;
+        out = (out == scratch.data()) ? scratch.data() + count * widest : scratch.data();
+    }
+
+    // Output layer has a single neuron
+    for (size_t row = 0; row < count; row++) {
+        outputs[row] = in[row];
+    }
+}
+
 // ==================== NEURAL NETWORK INFERENCE ====================
 
 float NeuralNet::predict(const Array &input_array) {
@@ -237,6 +297,7 @@ String NeuralNet::activation_int_to_string(int activation_type) const {
 
 void NeuralNet::initialize_neural_network(const Array &layer_sizes_array, const String &default_activation /* = "sigmoid" */) {
     // Clear existing network
+    model_checksum_valid = false;
     layer_sizes.clear();
     weights.clear();
     biases.clear();
@@ -399,6 +460,7 @@ void NeuralNet::set_layer_weights(int layer_index, const Array &weights_array, c
         for (int input = 0; input < input_size; input++) {
             weights[layer_index][neuron][input] = neuron_weights[input];
         }
+        model_checksum_valid = false;
 
         biases[layer_index][neuron] = biases_array[neuron];
     }
@@ -428,6 +490,8 @@ void NeuralNet::set_activation_function(int layer_index, const String &activatio
         return;
     }
 
+    model_checksum_valid = false;
+
     // Set for all hidden layers if layer_index is -1
     if (layer_index == -1) {
         for (size_t i = 0; i < activation_functions.size(); i++) {
@@ -465,7 +529,76 @@ String NeuralNet::get_activation_function(int layer_index) const {
     return activation_int_to_string(activation_functions[layer_index]);
 }
 
+// Little-endian, like FileAccess
+static inline void append_u32(std::vector<uint8_t> &out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static inline void append_floats(std::vector<uint8_t> &out, const float *values, size_t count) {
+    size_t offset = out.size();
+    out.resize(offset + count * sizeof(float));
+    memcpy(out.data() + offset, values, count * sizeof(float));
+}
+
+void NeuralNet::serialize_network(std::vector<uint8_t> &out) const {
+    // ==================== FILE FORMAT ====================
+    // Magic number (4 bytes): "NNWB" (Neural Network Weights Binary)
+    // Version (4 bytes): 1
+    // Num layers (4 bytes)
+    // Layer sizes (num_layers * 4 bytes)
+    // Num hidden layers (4 bytes)
+    // Activation functions (num_hidden_layers * 4 bytes)
+    // For each weight layer:
+    //   - Num weights (4 bytes)
+    //   - Weights (num_weights * 4 bytes as floats)
+    //   - Num biases (4 bytes)
+    //   - Biases (num_biases * 4 bytes as floats)
+    // ==================== END FORMAT ====================
+
+    size_t total = 4 + 4 + 4 + layer_sizes.size() * 4 + 4 + activation_functions.size() * 4;
+    for (size_t layer = 0; layer < weights.size(); layer++) {
+        total += 8 + (static_cast<size_t>(layer_sizes[layer + 1]) * (layer_sizes[layer] + 1)) * sizeof(float);
+    }
+    out.clear();
+    out.reserve(total);
+
+    // Magic number and version
+    out.push_back('N');
+    out.push_back('N');
+    out.push_back('W');
+    out.push_back('B');
+    append_u32(out, 1);
+
+    // Layer sizes
+    append_u32(out, static_cast<uint32_t>(layer_sizes.size()));
+    for (size_t i = 0; i < layer_sizes.size(); i++) {
+        append_u32(out, static_cast<uint32_t>(layer_sizes[i]));
+    }
+
+    // Activation functions
+    append_u32(out, static_cast<uint32_t>(activation_functions.size()));
+    for (size_t i = 0; i < activation_functions.size(); i++) {
+        append_u32(out, static_cast<uint32_t>(activation_functions[i]));
+    }
+
+    // Weights and biases
+    for (size_t layer = 0; layer < weights.size(); layer++) {
+        int output_size = layer_sizes[layer + 1];
+        int input_size = layer_sizes[layer];
+
+        append_u32(out, static_cast<uint32_t>(output_size * input_size));
+        for (int neuron = 0; neuron < output_size; neuron++) {
+            append_floats(out, weights[layer][neuron].data(), input_size);
+        }
+
+        append_u32(out, static_cast<uint32_t>(output_size));
+        append_floats(out, biases[layer].data(), output_size);
+    }
+}
+
 bool NeuralNet::save_network(const String &filename) {
+    TRACE_SCOPE("model_save");
+
     if (!network_initialized) {
         UtilityFunctions::print("Error: Cannot save uninitialized network");
         return false;
@@ -499,61 +632,9 @@ bool NeuralNet::save_network(const String &filename) {
         return false;
     }
 
-    // ==================== FILE FORMAT ====================
-    // Magic number (4 bytes): "NNWB" (Neural Network Weights Binary)
-    // Version (4 bytes): 1
-    // Num layers (4 bytes)
-    // Layer sizes (num_layers * 4 bytes)
-    // Num hidden layers (4 bytes)
-    // Activation functions (num_hidden_layers * 4 bytes)
-    // For each weight layer:
-    //   - Num weights (4 bytes)
-    //   - Weights (num_weights * 4 bytes as floats)
-    //   - Num biases (4 bytes)
-    //   - Biases (num_biases * 4 bytes as floats)
-    // ==================== END FORMAT ====================
-
-    // Write magic number
-    file->store_8('N');
-    file->store_8('N');
-    file->store_8('W');
-    file->store_8('B');
-
-    // Write version
-    file->store_32(1);
-
-    // Write layer sizes
-    file->store_32(layer_sizes.size());
-    for (size_t i = 0; i < layer_sizes.size(); i++) {
-        file->store_32(layer_sizes[i]);
-    }
-
-    // Write activation functions
-    file->store_32(activation_functions.size());
-    for (size_t i = 0; i < activation_functions.size(); i++) {
-        file->store_32(activation_functions[i]);
-    }
-
-    // Write weights and biases
-    for (size_t layer = 0; layer < weights.size(); layer++) {
-        int output_size = layer_sizes[layer + 1];
-        int input_size = layer_sizes[layer];
-
-        // Write weights for this layer
-        file->store_32(output_size * input_size);
-        for (int neuron = 0; neuron < output_size; neuron++) {
-            for (int input = 0; input < input_size; input++) {
-                file->store_float(weights[layer][neuron][input]);
-            }
-        }
-
-        // Write biases for this layer
-        file->store_32(output_size);
-        for (int neuron = 0; neuron < output_size; neuron++) {
-            file->store_float(biases[layer][neuron]);
-        }
-    }
-
+    std::vector<uint8_t> data;
+    serialize_network(data);
+    file->store_buffer(data.data(), data.size());
     file->close();
 
     UtilityFunctions::print("Neural network saved successfully to ", full_path);
@@ -561,6 +642,8 @@ bool NeuralNet::save_network(const String &filename) {
 }
 
 bool NeuralNet::load_network(const String &filename) {
+    TRACE_SCOPE("model_load");
+
     // Construct full path
     String full_path = "res://models/" + filename;
     if (!full_path.ends_with(".nn")) {
@@ -596,6 +679,7 @@ bool NeuralNet::load_network(const String &filename) {
     }
 
     // Clear existing network
+    model_checksum_valid = false;
     layer_sizes.clear();
     weights.clear();
     biases.clear();
@@ -691,14 +775,362 @@ bool NeuralNet::load_network(const String &filename) {
     return true;
 }
 
+// ==================== ASYNC CHECKPOINTS ====================
+
+#define CHECKPOINT_DIGITS 6
+
+// Sequence number of "<stem>.000042<extension>", or -1 for other file names
+static int64_t checkpoint_sequence(const std::string &name, const std::string &stem, const std::string &extension) {
+    if (name.size() != stem.size() + 1 + CHECKPOINT_DIGITS + extension.size()) return -1;
+    if (name.compare(0, stem.size(), stem) != 0 || name[stem.size()] != '.') return -1;
+    if (name.compare(name.size() - extension.size(), extension.size(), extension) != 0) return -1;
+
+    int64_t sequence = 0;
+    for (size_t i = stem.size() + 1; i < stem.size() + 1 + CHECKPOINT_DIGITS; i++) {
+        if (name[i] < '0' || name[i] > '9') return -1;
+        sequence = sequence * 10 + (name[i] - '0');
+    }
+    return sequence;
+}
+
+// Writes data to path through a temporary file, so readers never see a partial checkpoint
+static bool write_file_atomic(const std::filesystem::path &path, const std::vector<uint8_t> &data) {
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+
+    FILE *file = fopen(temp_path.string().c_str(), "wb");
+    if (!file) return false;
+
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size() && fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = (fclose(file) == 0) && ok;
+
+    std::error_code error;
+    if (ok) std::filesystem::rename(temp_path, path, error);
+    if (!ok || error) {
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+void NeuralNet::checkpoint_worker() {
+    std::unique_lock<std::mutex> lock(checkpoint_mutex);
+    while (true) {
+        checkpoint_cv.wait(lock, [this]() { return queued_checkpoint || checkpoint_stop; });
+        // Queued work is still written when stopping
+        if (!queued_checkpoint) break;
+
+        std::unique_ptr<CheckpointJob> job = std::move(queued_checkpoint);
+        checkpoint_writing = true;
+        lock.unlock();
+
+        TRACE_SCOPE("model_checkpoint");
+
+        // Next number after every checkpoint of this stem already on disk (also from earlier runs)
+        std::error_code error;
+        const std::filesystem::path dir = std::filesystem::u8path(job->native_dir);
+        std::vector<std::pair<int64_t, std::filesystem::path>> existing;
+        for (const auto &entry : std::filesystem::directory_iterator(dir, error)) {
+            int64_t sequence = checkpoint_sequence(entry.path().filename().u8string(), job->stem, job->extension);
+            if (sequence >= 0) existing.emplace_back(sequence, entry.path());
+        }
+        std::sort(existing.begin(), existing.end());
+        int64_t sequence = existing.empty() ? 1 : existing.back().first + 1;
+
+        char number[16];
+        snprintf(number, sizeof(number), ".%0*lld", CHECKPOINT_DIGITS, static_cast<long long>(sequence));
+        const std::string name = job->stem + number + job->extension;
+
+        bool ok = write_file_atomic(dir / std::filesystem::u8path(name), job->data);
+        if (ok) {
+            // This checkpoint plus the newest keep - 1 older ones survive
+            size_t keep_older = static_cast<size_t>(std::max(job->keep - 1, 0));
+            for (size_t i = 0; i + keep_older < existing.size(); i++) {
+                std::filesystem::remove(existing[i].second, error);
+            }
+        }
+
+        call_deferred("emit_signal", "checkpoint_saved", job->godot_dir.path_join(String::utf8(name.c_str())), ok);
+
+        lock.lock();
+        checkpoint_writing = false;
+        checkpoint_cv.notify_all();
+    }
+}
+
+bool NeuralNet::checkpoint_async(const String &path, int keep) {
+    if (!network_initialized) {
+        UtilityFunctions::print("Error: Cannot checkpoint uninitialized network");
+        return false;
+    }
+    if (keep < 1) {
+        UtilityFunctions::print("Error: checkpoint_async needs keep >= 1");
+        return false;
+    }
+
+    // Same conventions as save_network for relative names
+    String full_path = path.is_absolute_path() ? path : "res://models/" + path;
+    if (full_path.get_extension().is_empty()) {
+        full_path += ".nn";
+    }
+
+    auto job = std::make_unique<CheckpointJob>();
+    job->godot_dir = full_path.get_base_dir();
+    job->native_dir = ProjectSettings::get_singleton()->globalize_path(job->godot_dir).utf8().get_data();
+    job->stem = full_path.get_file().get_basename().utf8().get_data();
+    job->extension = ("." + full_path.get_extension()).utf8().get_data();
+    job->keep = keep;
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::u8path(job->native_dir), error);
+    if (error) {
+        UtilityFunctions::print("Error: Cannot create checkpoint directory: ", job->godot_dir);
+        return false;
+    }
+
+    // The snapshot: training may continue as soon as the weights are copied
+    {
+        TRACE_SCOPE("model_snapshot");
+        serialize_network(job->data);
+    }
+
+    std::lock_guard<std::mutex> lock(checkpoint_mutex);
+    queued_checkpoint = std::move(job);
+    if (!checkpoint_thread.joinable()) {
+        checkpoint_thread = std::thread(&NeuralNet::checkpoint_worker, this);
+    }
+    checkpoint_cv.notify_all();
+    return true;
+}
+
+bool NeuralNet::is_checkpoint_pending() {
+    std::lock_guard<std::mutex> lock(checkpoint_mutex);
+    return queued_checkpoint != nullptr || checkpoint_writing;
+}
+
+void NeuralNet::wait_for_checkpoints() {
+    std::unique_lock<std::mutex> lock(checkpoint_mutex);
+    checkpoint_cv.wait(lock, [this]() { return !queued_checkpoint && !checkpoint_writing; });
+}
+
+// ==================== MODEL IDENTITY ====================
+
+// FNV-1a over the raw bytes of a buffer
+static inline uint32_t fnv1a(uint32_t h, const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ bytes[i]) * 16777619u;
+    }
+    return h;
+}
+
+uint32_t NeuralNet::get_model_checksum() {
+    if (!network_initialized) return 0;
+    if (model_checksum_valid) return model_checksum;
+
+    uint32_t h = 2166136261u;
+    h = fnv1a(h, layer_sizes.data(), layer_sizes.size() * sizeof(int));
+    h = fnv1a(h, activation_functions.data(), activation_functions.size() * sizeof(int));
+    for (size_t layer = 0; layer < weights.size(); layer++) {
+        for (size_t neuron = 0; neuron < weights[layer].size(); neuron++) {
+            h = fnv1a(h, weights[layer][neuron].data(), weights[layer][neuron].size() * sizeof(float));
+        }
+        h = fnv1a(h, biases[layer].data(), biases[layer].size() * sizeof(float));
+    }
+
+    // 0 is reserved for "no network" (material evaluation)
+    model_checksum = (h == 0) ? 1 : h;
+    model_checksum_valid = true;
+    return model_checksum;
+}
+
+// ==================== VALIDATION ====================
+
+#define EVAL_BATCH_SIZE 256
+#define EVAL_CALIBRATION_BINS 10
+
+// Same scale as Agent::score_to_target, clamped the same way
+static inline float target_to_centipawns(float target) {
+    target = std::min(std::max(target, 0.01f), 0.99f);
+    return 600.0f * std::log(target / (1.0f - target));
+}
+
+struct EvalTotals {
+    uint64_t records = 0;
+    double squared_error = 0.0;
+    double abs_cp_error = 0.0;
+    uint64_t decisive = 0;              // Records from won/lost games
+    uint64_t decisive_correct = 0;      // ... whose prediction favours the winner
+    uint64_t bin_count[EVAL_CALIBRATION_BINS] = {};
+    double bin_prediction[EVAL_CALIBRATION_BINS] = {};
+    double bin_target[EVAL_CALIBRATION_BINS] = {};
+
+    void add(const EvalTotals &other) {
+        records += other.records;
+        squared_error += other.squared_error;
+        abs_cp_error += other.abs_cp_error;
+        decisive += other.decisive;
+        decisive_correct += other.decisive_correct;
+        for (int b = 0; b < EVAL_CALIBRATION_BINS; b++) {
+            bin_count[b] += other.bin_count[b];
+            bin_prediction[b] += other.bin_prediction[b];
+            bin_target[b] += other.bin_target[b];
+        }
+    }
+};
+
+Dictionary NeuralNet::evaluate_dataset(const String &path, int threads, int64_t max_records) {
+    Dictionary result;
+    result["ok"] = false;
+
+    if (!network_initialized) {
+        result["error"] = "network not initialized";
+        return result;
+    }
+    if (layer_sizes[0] != NN_TOTAL_INPUTS || layer_sizes.back() != 1) {
+        result["error"] = "network does not use the board feature layout";
+        return result;
+    }
+
+    CharString native = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+    std::string dataset_path = native.get_data();
+    DatasetHeader header;
+    if (!read_dataset_header(dataset_path.c_str(), header)) {
+        result["error"] = "cannot open dataset";
+        return result;
+    }
+
+    TRACE_SCOPE("evaluate_dataset");
+    auto start_time = std::chrono::steady_clock::now();
+
+    uint64_t limit = max_records > 0 ? std::min<uint64_t>(max_records, header.record_count) : header.record_count;
+    int worker_count = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    worker_count = static_cast<int>(std::max<uint64_t>(1, std::min<uint64_t>(std::max(1, worker_count), limit / EVAL_BATCH_SIZE)));
+
+    std::vector<EvalTotals> worker_totals(worker_count);
+    std::atomic<bool> read_failed{false};
+    std::vector<std::thread> workers;
+
+    for (int w = 0; w < worker_count; w++) {
+        workers.emplace_back([&, w]() {
+            const uint64_t begin = limit * w / worker_count;
+            const uint64_t end = limit * (w + 1) / worker_count;
+
+            DatasetReader reader;
+            if (!reader.open(dataset_path.c_str()) || !reader.seek(begin)) {
+                read_failed = true;
+                return;
+            }
+
+            std::vector<TrainingRecord> batch(EVAL_BATCH_SIZE);
+            std::vector<float> inputs(static_cast<size_t>(EVAL_BATCH_SIZE) * NN_TOTAL_INPUTS);
+            std::vector<float> targets(EVAL_BATCH_SIZE);
+            std::vector<int8_t> results(EVAL_BATCH_SIZE);
+            std::vector<float> outputs(EVAL_BATCH_SIZE);
+            std::vector<float> scratch;
+            EvalTotals &totals = worker_totals[w];
+            Position pos;
+
+            uint64_t consumed = begin;
+            size_t n;
+            while (consumed < end &&
+                   (n = reader.read(batch.data(), static_cast<size_t>(std::min<uint64_t>(EVAL_BATCH_SIZE, end - consumed)))) > 0) {
+                consumed += n;
+
+                size_t rows = 0;
+                for (size_t i = 0; i < n; i++) {
+                    if (!unpack_position(batch[i].position, pos)) continue;
+                    Features::extract(pos, COLOR_WHITE, inputs.data() + rows * NN_TOTAL_INPUTS);
+                    targets[rows] = batch[i].target;
+                    results[rows] = batch[i].result;
+                    rows++;
+                }
+                if (rows == 0) continue;
+
+                forward_batch(inputs.data(), rows, scratch, outputs.data());
+                EngineMetrics::nn_evaluations.fetch_add(rows, std::memory_order_relaxed);
+
+                for (size_t i = 0; i < rows; i++) {
+                    const float prediction = outputs[i];
+                    const float error = prediction - targets[i];
+                    totals.squared_error += error * error;
+                    totals.abs_cp_error += std::fabs(target_to_centipawns(prediction) - target_to_centipawns(targets[i]));
+
+                    if (results[i] != RESULT_DRAW) {
+                        totals.decisive++;
+                        if ((prediction > 0.5f) == (results[i] == RESULT_WHITE_WIN)) totals.decisive_correct++;
+                    }
+
+                    int bin = std::min(static_cast<int>(prediction * EVAL_CALIBRATION_BINS), EVAL_CALIBRATION_BINS - 1);
+                    bin = std::max(bin, 0);
+                    totals.bin_count[bin]++;
+                    totals.bin_prediction[bin] += prediction;
+                    totals.bin_target[bin] += targets[i];
+                }
+                totals.records += rows;
+            }
+        });
+    }
+    for (std::thread &worker : workers) worker.join();
+
+    if (read_failed) {
+        result["error"] = "cannot read dataset";
+        return result;
+    }
+
+    EvalTotals total;
+    for (const EvalTotals &totals : worker_totals) total.add(totals);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    const double records = static_cast<double>(std::max<uint64_t>(total.records, 1));
+
+    Array calibration;
+    for (int b = 0; b < EVAL_CALIBRATION_BINS; b++) {
+        Dictionary bin;
+        const double bin_records = static_cast<double>(std::max<uint64_t>(total.bin_count[b], 1));
+        bin["count"] = static_cast<int64_t>(total.bin_count[b]);
+        bin["mean_prediction"] = total.bin_prediction[b] / bin_records;
+        bin["mean_target"] = total.bin_target[b] / bin_records;
+        calibration.append(bin);
+    }
+
+    result["ok"] = true;
+    result["records"] = static_cast<int64_t>(total.records);
+    result["mse"] = total.squared_error / records;
+    result["mean_abs_cp_error"] = total.abs_cp_error / records;
+    result["result_accuracy"] = total.decisive > 0 ? static_cast<double>(total.decisive_correct) / total.decisive : 0.0;
+    result["calibration"] = calibration;
+    result["seconds"] = seconds;
+    result["positions_per_second"] = seconds > 0.0 ? total.records / seconds : 0.0;
+    return result;
+}
+
 // ==================== CONSTRUCTOR/DESTRUCTOR ====================
 
 NeuralNet::NeuralNet() {
     network_initialized = false;
+    model_checksum = 0;
+    model_checksum_valid = false;
+    checkpoint_writing = false;
+    checkpoint_stop = false;
     init_sigmoid_lut();
 }
 
 NeuralNet::~NeuralNet() {
+    // Finish a queued checkpoint instead of losing it
+    {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex);
+        checkpoint_stop = true;
+    }
+    checkpoint_cv.notify_all();
+    if (checkpoint_thread.joinable()) {
+        checkpoint_thread.join();
+    }
 }
 
 void NeuralNet::_ready() {
@@ -795,6 +1227,8 @@ void NeuralNet::update_weights(float learning_rate) {
         return;
     }
 
+    model_checksum_valid = false;
+
     // Update all weights and biases using gradient descent
     for (size_t layer = 0; layer < weights.size(); layer++) {
         for (size_t neuron = 0; neuron < weights[layer].size(); neuron++) {
@@ -815,32 +1249,129 @@ float NeuralNet::train_single_example(const Array &input_array, float target_out
         return 0.0f;
     }
 
+    float loss = train_array_example(input_array, target_output, learning_rate);
+    EngineMetrics::record_training(1, loss);
+    return loss;
+}
+
+float NeuralNet::train_array_example(const Array &input_array, float target_output, float learning_rate) {
+    if (!network_initialized) {
+        UtilityFunctions::print("Error: Network not initialized");
+        return 0.0f;
+    }
+
     // Convert Array to std::vector<float>
     std::vector<float> input_vec;
-    input_vec.reserve(input_array.size());
-    for (int i = 0; i < input_array.size(); i++) {
-        input_vec.push_back(input_array[i]);
+    {
+        PhaseTimer timer(training_stats, TRAINING_PHASE_MARSHALLING);
+        input_vec.reserve(input_array.size());
+        for (int i = 0; i < input_array.size(); i++) {
+            input_vec.push_back(input_array[i]);
+        }
     }
 
+    return train_example(input_vec, target_output, learning_rate);
+}
+
+float NeuralNet::train_example(const std::vector<float> &input_vec, float target_output, float learning_rate) {
     // 1. Forward pass (also stores activations and z-values)
-    float output = forward_pass(input_vec);
+    float output;
+    {
+        TRACE_SCOPE("nn_forward");
+        PhaseTimer timer(training_stats, TRAINING_PHASE_FORWARD);
+        output = forward_pass(input_vec);
+    }
 
     // 2. Compute loss (Mean Squared Error)
     float error = output - target_output;
     float loss = error * error;
 
-    // 3. Clear previous gradients
-    clear_gradients();
-
-    // 4. Backpropagation (compute gradients)
-    backpropagate(target_output);
+    // 3-4. Clear previous gradients, then backpropagation (compute gradients)
+    {
+        TRACE_SCOPE("nn_backward");
+        {
+            PhaseTimer timer(training_stats, TRAINING_PHASE_CLEAR_GRADIENTS);
+            clear_gradients();
+        }
+        PhaseTimer timer(training_stats, TRAINING_PHASE_BACKPROP);
+        backpropagate(target_output);
+    }
 
     // 5. Update weights
-    update_weights(learning_rate);
+    {
+        TRACE_SCOPE("nn_update");
+        PhaseTimer timer(training_stats, TRAINING_PHASE_UPDATE);
+        update_weights(learning_rate);
+    }
 
+    training_stats.examples++;
+    training_stats.flops += flops_per_example();
     return loss;
 }
 
+// ==================== TRAINING PROFILER ====================
+
+uint64_t NeuralNet::flops_per_example() const {
+    uint64_t weight_count = 0;
+    for (size_t layer = 0; layer + 1 < layer_sizes.size(); layer++) {
+        weight_count += static_cast<uint64_t>(layer_sizes[layer]) * layer_sizes[layer + 1];
+    }
+    // Forward: one multiply-add per weight; backprop: one for the delta and one
+    // for the gradient; update: one
+    return 8 * weight_count;
+}
+
+Dictionary NeuralNet::get_training_stats() const {
+    uint64_t total_ns = 0;
+    for (int phase = 0; phase < TRAINING_PHASE_COUNT; phase++) {
+        total_ns += training_stats.phase_ns[phase];
+    }
+    const uint64_t compute_ns = training_stats.phase_ns[TRAINING_PHASE_FORWARD] +
+                                training_stats.phase_ns[TRAINING_PHASE_BACKPROP] +
+                                training_stats.phase_ns[TRAINING_PHASE_UPDATE];
+    const double seconds = total_ns * 1e-9;
+
+    Dictionary phases;
+    for (int phase = 0; phase < TRAINING_PHASE_COUNT; phase++) {
+        Dictionary entry;
+        entry["seconds"] = training_stats.phase_ns[phase] * 1e-9;
+        entry["share"] = total_ns > 0 ? static_cast<double>(training_stats.phase_ns[phase]) / total_ns : 0.0;
+        phases[training_phase_name(phase)] = entry;
+    }
+
+    Dictionary stats;
+    stats["examples"] = static_cast<int64_t>(training_stats.examples);
+    stats["seconds"] = seconds;
+    stats["examples_per_second"] = seconds > 0.0 ? training_stats.examples / seconds : 0.0;
+    stats["flops"] = static_cast<int64_t>(training_stats.flops);
+    stats["flops_per_second"] = compute_ns > 0 ? training_stats.flops / (compute_ns * 1e-9) : 0.0;
+    stats["phases"] = phases;
+    return stats;
+}
+
+// ==================== EVENT TRACING ====================
+
+void NeuralNet::set_tracing_enabled(bool enabled) {
+#ifndef CHESS_TRACE
+    if (enabled) {
+        UtilityFunctions::print("Warning: Tracing is not compiled in. Rebuild with 'scons trace=yes'.");
+    }
+#endif
+    Trace::set_enabled(enabled);
+}
+
+bool NeuralNet::is_tracing_enabled() const {
+    return Trace::is_enabled();
+}
+
+bool NeuralNet::dump_trace(const String &path) {
+    return Trace::dump_chrome_trace(path.utf8().get_data());
+}
+
+void NeuralNet::clear_trace() {
+    Trace::clear();
+}
+
 // ==================== GODOT BINDINGS ====================
 
 void NeuralNet::_bind_methods() {
@@ -851,6 +1382,9 @@ void NeuralNet::_bind_methods() {
     ClassDB::bind_method(D_METHOD("initialize_neural_network", "layer_sizes", "activation"), &NeuralNet::initialize_neural_network, DEFVAL("sigmoid"));
     ClassDB::bind_method(D_METHOD("save_network", "filename"), &NeuralNet::save_network);
     ClassDB::bind_method(D_METHOD("load_network", "filename"), &NeuralNet::load_network);
+    ClassDB::bind_method(D_METHOD("checkpoint_async", "path", "keep"), &NeuralNet::checkpoint_async, DEFVAL(3));
+    ClassDB::bind_method(D_METHOD("is_checkpoint_pending"), &NeuralNet::is_checkpoint_pending);
+    ClassDB::bind_method(D_METHOD("wait_for_checkpoints"), &NeuralNet::wait_for_checkpoints);
     ClassDB::bind_method(D_METHOD("set_layer_weights", "layer_index", "weights", "biases"), &NeuralNet::set_layer_weights);
     ClassDB::bind_method(D_METHOD("set_activation_function", "layer_index", "activation_type"), &NeuralNet::set_activation_function);
     ClassDB::bind_method(D_METHOD("get_activation_function", "layer_index"), &NeuralNet::get_activation_function);
@@ -858,8 +1392,22 @@ void NeuralNet::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_layer_sizes"), &NeuralNet::get_layer_sizes);
     ClassDB::bind_method(D_METHOD("get_num_layers"), &NeuralNet::get_num_layers);
     ClassDB::bind_method(D_METHOD("get_input_size"), &NeuralNet::get_input_size);
+    ClassDB::bind_method(D_METHOD("get_model_checksum"), &NeuralNet::get_model_checksum);
+
+    // Validation
+    ClassDB::bind_method(D_METHOD("evaluate_dataset", "path", "threads", "max_records"), &NeuralNet::evaluate_dataset, DEFVAL(0), DEFVAL(0));
 
     // Training methods
     ClassDB::bind_method(D_METHOD("train_single_example", "input_features", "target_output", "learning_rate"), &NeuralNet::train_single_example);
+    ClassDB::bind_method(D_METHOD("get_training_stats"), &NeuralNet::get_training_stats);
+    ClassDB::bind_method(D_METHOD("reset_training_stats"), &NeuralNet::reset_training_stats);
+
+    // Event tracing (shared by all instances)
+    ClassDB::bind_method(D_METHOD("set_tracing_enabled", "enabled"), &NeuralNet::set_tracing_enabled);
+    ClassDB::bind_method(D_METHOD("is_tracing_enabled"), &NeuralNet::is_tracing_enabled);
+    ClassDB::bind_method(D_METHOD("dump_trace", "path"), &NeuralNet::dump_trace);
+    ClassDB::bind_method(D_METHOD("clear_trace"), &NeuralNet::clear_trace);
+
+    ADD_SIGNAL(MethodInfo("checkpoint_saved", PropertyInfo(Variant::STRING, "path"), PropertyInfo(Variant::BOOL, "ok")));
 }
 
@@ -6,8 +6,14 @@
 #include <godot_cpp/classes/dir_access.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include "training_stats.h"
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 #include <algorithm>
 
@@ -40,6 +46,35 @@ protected:
     // Network initialized flag
     bool network_initialized;
 
+    // Cached get_model_checksum() result, cleared whenever weights or architecture change
+    uint32_t model_checksum;
+    bool model_checksum_valid;
+
+    // Writes the .nn file format (see save_network) into a byte buffer
+    void serialize_network(std::vector<uint8_t> &out) const;
+
+    // ==================== ASYNC CHECKPOINTS ====================
+
+    // Snapshot waiting for the writer thread. Only the newest one is kept:
+    // a checkpoint requested while another is still queued replaces it
+    struct CheckpointJob {
+        std::vector<uint8_t> data;
+        std::string native_dir;     // Directory in the OS file system
+        String godot_dir;           // Same directory as a res:// / user:// path (for the signal)
+        std::string stem;           // File name without extension
+        std::string extension;      // Including the dot
+        int keep;
+    };
+
+    std::thread checkpoint_thread;
+    std::mutex checkpoint_mutex;
+    std::condition_variable checkpoint_cv;
+    std::unique_ptr<CheckpointJob> queued_checkpoint;
+    bool checkpoint_writing;
+    bool checkpoint_stop;
+
+    void checkpoint_worker();
+
     // ==================== TRAINING INFRASTRUCTURE ====================
 
     // Gradients for backpropagation (same structure as weights/biases)
@@ -52,6 +87,12 @@ protected:
     // Delta values for backpropagation
     std::vector<std::vector<float>> deltas;
 
+    // Cumulative phase timers and counters of all training calls (get_training_stats)
+    TrainingStats training_stats;
+
+    // FLOPs of one training step: forward, backprop and update at 2 per multiply-add
+    uint64_t flops_per_example() const;
+
     // Forward pass through neural network with provided input features
     // Returns the network output value (between 0 and 1 via sigmoid)
     float forward_pass(const std::vector<float> &input_features);
@@ -62,6 +103,12 @@ protected:
     void forward_pass_sigmoid(size_t layer_idx);
     void forward_pass_tanh(size_t layer_idx);
 
+    // Inference-only forward pass over `count` input rows (input_size floats each).
+    // Each weight row is applied to the whole batch while it is in cache. Reads
+    // only weights and biases, so several threads may run it concurrently as
+    // long as the network isn't trained or reloaded meanwhile
+    void forward_batch(const float *inputs, size_t count, std::vector<float> &scratch, float *outputs) const;
+
     // ==================== FAST SIGMOID LOOKUP TABLE ====================
     static constexpr int SIGMOID_LUT_SIZE = 4096;
     static constexpr float SIGMOID_LUT_RANGE = 8.0f;  // Cover [-8, 8]
@@ -87,6 +134,16 @@ protected:
     inline float tanh_activation(float x) const { return std::tanh(x); }
     inline float linear(float x) const { return x; }
 
+    // Hidden layer activation by type (same mapping as forward_pass)
+    inline float activate(int activation_type, float x) const {
+        switch (activation_type) {
+            case 0: return linear(x);
+            case 1: return relu(x);
+            case 3: return tanh_activation(x);
+            default: return sigmoid(x);
+        }
+    }
+
 protected:
     static void _bind_methods();
 
@@ -145,6 +202,36 @@ public:
     // Get the expected input size for this network
     int get_input_size() const { return layer_sizes.empty() ? 0 : layer_sizes[0]; }
 
+    // Checksum of architecture, activations, weights and biases (0 if uninitialized)
+    // Identifies the model in persistent caches; recomputed only after changes
+    uint32_t get_model_checksum();
+
+    // ==================== VALIDATION ====================
+
+    // Score the network on a holdout dataset (.chds, see DatasetTools) without training.
+    // Records are split across `threads` workers (0 = all cores), each running batched
+    // forward passes. Requires the NN_TOTAL_INPUTS board feature layout.
+    // Returns {ok, records, mse, mean_abs_cp_error, result_accuracy, calibration,
+    //          seconds, positions_per_second, error}; calibration holds one
+    //          {count, mean_prediction, mean_target} per tenth of the output range
+    Dictionary evaluate_dataset(const String &path, int threads = 0, int64_t max_records = 0);
+
+    // ==================== ASYNC CHECKPOINTS ====================
+
+    // Save a checkpoint without blocking: the weights are copied into a buffer
+    // here, a background thread writes it to "<stem>.000042.nn" next to `path`
+    // (temporary file + atomic rename) and deletes all but the newest `keep`
+    // numbered checkpoints of that stem. Relative paths go to res://models/ like
+    // save_network. Emits checkpoint_saved(path, ok) on the main thread.
+    // Returns false if the snapshot could not be queued
+    bool checkpoint_async(const String &path, int keep = 3);
+
+    // True while a checkpoint is queued or being written
+    bool is_checkpoint_pending();
+
+    // Block until all queued checkpoints are on disk (e.g. before quitting)
+    void wait_for_checkpoints();
+
     // ==================== TRAINING METHODS ====================
 
     // Train on a single example (forward + backward pass + weight update)
@@ -154,6 +241,13 @@ public:
     // Returns the loss (mean squared error)
     float train_single_example(const Array &input_features, float target_output, float learning_rate);
 
+    // Same step without publishing EngineMetrics (batch callers record once per batch)
+    float train_array_example(const Array &input_features, float target_output, float learning_rate);
+
+    // Same training step on a native feature vector (no Variant conversion)
+    // Callers must check network_initialized and record the step in EngineMetrics
+    float train_example(const std::vector<float> &input_features, float target_output, float learning_rate);
+
     // Backpropagation: Compute gradients for a single example
     // target_output: The desired output value
     void backpropagate(float target_output);
@@ -165,11 +259,35 @@ public:
     // Clear all gradients (reset to zero)
     void clear_gradients();
 
+    // ==================== TRAINING PROFILER ====================
+
+    // Time spent per training phase since the last reset (marshalling, data_loading,
+    // features, forward, clear_gradients, backprop, update) with throughput:
+    // {examples, seconds, examples_per_second, flops, flops_per_second,
+    //  phases: {name: {seconds, share}}}
+    // flops_per_second covers the forward, backprop and update phases only
+    Dictionary get_training_stats() const;
+    void reset_training_stats() { training_stats.reset(); }
+
     // Derivative of activation functions
     inline float relu_derivative(float z) const { return (z > 0.0f) ? 1.0f : 0.0f; }
     inline float sigmoid_derivative(float activation) const { return activation * (1.0f - activation); }
     inline float tanh_derivative(float activation) const { return 1.0f - activation * activation; }
     inline float linear_derivative(float z) const { return 1.0f; }
+
+    // ==================== EVENT TRACING ====================
+
+    // Toggle span recording for search and training phases (process-wide)
+    // Requires a build with 'scons trace=yes', otherwise nothing is recorded
+    void set_tracing_enabled(bool enabled);
+    bool is_tracing_enabled() const;
+
+    // Write all recorded spans as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+    // Returns true on success
+    bool dump_trace(const String &path);
+
+    // Discard all recorded spans
+    void clear_trace();
 };
 
 #endif // NEURAL_NETWORK_H
@@ -0,0 +1,116 @@
+#include "nn_features.h"
+#include <algorithm>
+
+namespace Features {
+
+// Board transform of an augmented twin, applied before the perspective mirror
+static inline uint8_t augment_square(uint8_t square, uint8_t augmentation) {
+    if (augmentation & AUGMENT_COLOR_FLIP) square = mirror_square(square);
+    if (augmentation & AUGMENT_FILE_MIRROR) square = mirror_file(square);
+    return square;
+}
+
+void extract(const Position &pos, uint8_t color, float *out, uint8_t augmentation) {
+    std::fill(out, out + NN_TOTAL_INPUTS, 0.0f);
+
+    const uint8_t* squares = pos.get_squares();
+    const bool mirror_board = (color == COLOR_BLACK);
+    const bool flip_colors = (augmentation & AUGMENT_COLOR_FLIP) != 0;
+
+    // ==================== PIECE-SQUARE FEATURES (768 inputs) ====================
+    // 12 planes: P, N, B, R, Q, K (white), p, n, b, r, q, k (black)
+    // Each plane has 64 squares
+    // A colour-flipped twin puts white pieces on the black planes and vice versa
+
+    // Use piece lists for faster iteration (avoid scanning empty squares)
+    const uint8_t* white_pieces = pos.get_white_piece_list();
+    const uint8_t* black_pieces = pos.get_black_piece_list();
+    const uint8_t white_count = pos.get_white_piece_count();
+    const uint8_t black_count = pos.get_black_piece_count();
+    const int white_plane_base = flip_colors ? 6 : 0;
+    const int black_plane_base = flip_colors ? 0 : 6;
+
+    // Process white pieces
+    for (uint8_t i = 0; i < white_count; i++) {
+        const uint8_t sq = augment_square(white_pieces[i], augmentation);
+        const uint8_t piece = squares[white_pieces[i]];
+        const uint8_t piece_type = GET_PIECE_TYPE(piece);
+
+        // White pieces: P=0, N=1, B=2, R=3, Q=4, K=5
+        const int plane = (piece_type - 1) + white_plane_base;
+
+        // Mirror square horizontally if playing as black
+        const int feature_square = mirror_board ? mirror_square(sq) : sq;
+
+        // Feature index = plane * 64 + square
+        const int feature_idx = plane * 64 + feature_square;
+        out[feature_idx] = 1.0f;
+    }
+
+    // Process black pieces
+    for (uint8_t i = 0; i < black_count; i++) {
+        const uint8_t sq = augment_square(black_pieces[i], augmentation);
+        const uint8_t piece = squares[black_pieces[i]];
+        const uint8_t piece_type = GET_PIECE_TYPE(piece);
+
+        // Black pieces: p=6, n=7, b=8, r=9, q=10, k=11
+        const int plane = (piece_type - 1) + black_plane_base;
+
+        // Mirror square horizontally if playing as black
+        const int feature_square = mirror_board ? mirror_square(sq) : sq;
+
+        // Feature index = plane * 64 + square
+        const int feature_idx = plane * 64 + feature_square;
+        out[feature_idx] = 1.0f;
+    }
+
+    // ==================== CASTLING RIGHTS (4 inputs) ====================
+    // File-mirrored twins are only produced without castling rights, so only
+    // the colour flip changes them
+    const uint8_t rights = pos.get_castling_rights();
+    bool castling[4] = {(rights & CASTLE_WHITE_KINGSIDE) != 0, (rights & CASTLE_WHITE_QUEENSIDE) != 0,
+                        (rights & CASTLE_BLACK_KINGSIDE) != 0, (rights & CASTLE_BLACK_QUEENSIDE) != 0};
+    if (flip_colors) {
+        std::swap(castling[0], castling[2]);
+        std::swap(castling[1], castling[3]);
+    }
+    int castling_offset = NN_PIECE_INPUTS;  // 768
+
+    if (mirror_board) {
+        // Mirror castling rights horizontally: swap white and black castling rights
+        out[castling_offset + 0] = castling[2] ? 1.0f : 0.0f;  // Black Kingside → position 0
+        out[castling_offset + 1] = castling[3] ? 1.0f : 0.0f;  // Black Queenside → position 1
+        out[castling_offset + 2] = castling[0] ? 1.0f : 0.0f;  // White Kingside → position 2
+        out[castling_offset + 3] = castling[1] ? 1.0f : 0.0f;  // White Queenside → position 3
+    } else {
+        out[castling_offset + 0] = castling[0] ? 1.0f : 0.0f;  // White Kingside
+        out[castling_offset + 1] = castling[1] ? 1.0f : 0.0f;  // White Queenside
+        out[castling_offset + 2] = castling[2] ? 1.0f : 0.0f;  // Black Kingside
+        out[castling_offset + 3] = castling[3] ? 1.0f : 0.0f;  // Black Queenside
+    }
+
+    // ==================== SIDE TO MOVE (1 input) ====================
+    int turn_offset = castling_offset + NN_CASTLING_INPUTS;  // 772
+    const uint8_t turn = flip_colors ? 1 - pos.turn : pos.turn;
+    if (mirror_board) {
+        // From black's mirrored perspective: 1.0 = black to move, 0.0 = white to move
+        out[turn_offset] = (turn == 1) ? 1.0f : 0.0f;
+    } else {
+        out[turn_offset] = (turn == 0) ? 1.0f : 0.0f;  // 1.0 = white to move
+    }
+
+    // ==================== EN PASSANT (8 inputs, one-hot by file) ====================
+    int ep_offset = turn_offset + NN_TURN_INPUT;  // 773
+    uint8_t ep_target = pos.get_en_passant_target();
+    if (ep_target != 255) {
+        ep_target = augment_square(ep_target, augmentation);
+
+        // Mirror en passant square if playing as black
+        uint8_t mirrored_ep = mirror_board ? mirror_square(ep_target) : ep_target;
+        int ep_file = mirrored_ep % 8;
+        out[ep_offset + ep_file] = 1.0f;
+    }
+    // If no en passant, all 8 inputs remain 0.0
+}
+
+} // namespace Features
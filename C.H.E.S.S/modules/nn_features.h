@@ -0,0 +1,62 @@
+#ifndef NN_FEATURES_H
+#define NN_FEATURES_H
+
+#include "position.h"
+#include <cstdint>
+
+// ==================== NEURAL NETWORK INPUT CONFIGURATION ====================
+
+// Input layer size: 12 piece types × 64 squares + extras
+// Piece planes: P, N, B, R, Q, K (white), p, n, b, r, q, k (black)
+#define NN_PIECE_PLANES     12
+#define NN_SQUARES          64
+#define NN_PIECE_INPUTS     (NN_PIECE_PLANES * NN_SQUARES)  // 768
+
+// Additional inputs
+#define NN_CASTLING_INPUTS  4   // WK, WQ, BK, BQ
+#define NN_TURN_INPUT       1   // Side to move (1.0 = white, 0.0 = black)
+#define NN_EP_INPUTS        8   // En passant file (one-hot, or 0 if none)
+
+// Total input size
+#define NN_TOTAL_INPUTS     (NN_PIECE_INPUTS + NN_CASTLING_INPUTS + NN_TURN_INPUT + NN_EP_INPUTS)  // 781
+
+// Feature extraction on a bare Position (Godot-free)
+// Shared by the Agent (live board) and the training paths that replay stored
+// positions, so both always produce identical inputs.
+namespace Features {
+
+// ==================== AUGMENTATION ====================
+// Twins of a stored position, encoded at feature-expansion time (nothing extra is stored)
+#define AUGMENT_NONE        0
+#define AUGMENT_COLOR_FLIP  1   // Colours swapped, ranks mirrored, side to move flipped
+#define AUGMENT_FILE_MIRROR 2   // Files mirrored (a ↔ h); only valid without castling rights
+
+// Mirror a square index horizontally (rank 0 ↔ rank 7, etc.)
+inline uint8_t mirror_square(uint8_t square) {
+    return (7 - square / 8) * 8 + square % 8;
+}
+
+// Mirror a square across the board's vertical axis (file a ↔ file h)
+inline uint8_t mirror_file(uint8_t square) {
+    return square ^ 7;
+}
+
+// File mirroring changes the game only through castling
+inline bool can_mirror_files(const Position &pos) {
+    return pos.get_castling_rights() == 0;
+}
+
+// Target of a twin, given the stored target (0.0-1.0) for the same perspective:
+// after a colour flip the perspective's side has swapped places with its opponent
+inline float augment_target(float target, uint8_t augmentation) {
+    return (augmentation & AUGMENT_COLOR_FLIP) ? 1.0f - target : target;
+}
+
+// Writes NN_TOTAL_INPUTS floats to out
+// If color is COLOR_BLACK (16), mirrors the board horizontally
+// augmentation (AUGMENT_* bits) encodes a symmetric twin of pos instead
+void extract(const Position &pos, uint8_t color, float *out, uint8_t augmentation = AUGMENT_NONE);
+
+} // namespace Features
+
+#endif // NN_FEATURES_H
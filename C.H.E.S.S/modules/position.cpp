@@ -0,0 +1,1501 @@
+#include "position.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+// ==================== STATIC MEMBER DEFINITIONS ====================
+
+bool Position::tables_initialized = false;
+uint8_t Position::knight_attack_squares[64][8];
+uint8_t Position::knight_attack_count[64];
+uint8_t Position::king_attack_squares[64][8];
+uint8_t Position::king_attack_count[64];
+uint8_t Position::squares_to_edge[64][8];
+uint8_t Position::castling_mask[64];
+
+// Knight move offsets: {file_delta, rank_delta}
+static const int KNIGHT_DELTAS[8][2] = {
+    {1, 2}, {2, 1}, {2, -1}, {1, -2},
+    {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}
+};
+
+// King move offsets
+static const int KING_DELTAS[8][2] = {
+    {0, 1}, {0, -1}, {1, 0}, {-1, 0},
+    {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+};
+
+// ==================== STATIC INITIALIZATION ====================
+
+void Position::init_attack_tables() {
+    if (tables_initialized) return;
+    Zobrist::init();
+    
+    for (int sq = 0; sq < 64; sq++) {
+        int file = sq % 8;
+        int rank = sq / 8;
+        
+        // Knight attacks
+        knight_attack_count[sq] = 0;
+        for (int i = 0; i < 8; i++) {
+            int new_file = file + KNIGHT_DELTAS[i][0];
+            int new_rank = rank + KNIGHT_DELTAS[i][1];
+            if (new_file >= 0 && new_file < 8 && new_rank >= 0 && new_rank < 8) {
+                knight_attack_squares[sq][knight_attack_count[sq]++] = new_rank * 8 + new_file;
+            }
+        }
+        
+        // King attacks
+        king_attack_count[sq] = 0;
+        for (int i = 0; i < 8; i++) {
+            int new_file = file + KING_DELTAS[i][0];
+            int new_rank = rank + KING_DELTAS[i][1];
+            if (new_file >= 0 && new_file < 8 && new_rank >= 0 && new_rank < 8) {
+                king_attack_squares[sq][king_attack_count[sq]++] = new_rank * 8 + new_file;
+            }
+        }
+        
+        // Squares to edge
+        squares_to_edge[sq][0] = 7 - rank;
+        squares_to_edge[sq][1] = rank;
+        squares_to_edge[sq][2] = 7 - file;
+        squares_to_edge[sq][3] = file;
+        squares_to_edge[sq][4] = (7 - rank < 7 - file) ? 7 - rank : 7 - file;
+        squares_to_edge[sq][5] = (7 - rank < file) ? 7 - rank : file;
+        squares_to_edge[sq][6] = (rank < 7 - file) ? rank : 7 - file;
+        squares_to_edge[sq][7] = (rank < file) ? rank : file;
+
+        castling_mask[sq] = CASTLE_ALL;
+    }
+
+    castling_mask[4] = CASTLE_ALL & ~(CASTLE_WHITE_KINGSIDE | CASTLE_WHITE_QUEENSIDE);
+    castling_mask[7] = CASTLE_ALL & ~CASTLE_WHITE_KINGSIDE;
+    castling_mask[0] = CASTLE_ALL & ~CASTLE_WHITE_QUEENSIDE;
+    castling_mask[60] = CASTLE_ALL & ~(CASTLE_BLACK_KINGSIDE | CASTLE_BLACK_QUEENSIDE);
+    castling_mask[63] = CASTLE_ALL & ~CASTLE_BLACK_KINGSIDE;
+    castling_mask[56] = CASTLE_ALL & ~CASTLE_BLACK_QUEENSIDE;
+    
+    tables_initialized = true;
+}
+
+// ==================== CONSTRUCTOR ====================
+
+Position::Position() {
+    init_attack_tables();
+    clear_board();
+}
+
+// ==================== ZOBRIST HASHING ====================
+
+int Position::get_zobrist_piece_index(uint8_t piece) const {
+    if (IS_EMPTY(piece)) return -1;
+    
+    uint8_t type = GET_PIECE_TYPE(piece);
+    bool is_white = IS_WHITE(piece);
+    
+    return (type - 1) + (is_white ? 0 : 6);
+}
+
+void Position::hash_piece(uint8_t piece, uint8_t square) {
+    int piece_index = get_zobrist_piece_index(piece);
+    if (piece_index >= 0 && square < 64) {
+        current_hash ^= Zobrist::piece_keys[piece_index][square];
+    }
+}
+
+void Position::hash_castling(uint8_t old_rights, uint8_t new_rights) {
+    current_hash ^= Zobrist::castling_keys[old_rights] ^ Zobrist::castling_keys[new_rights];
+}
+
+void Position::hash_en_passant(uint8_t ep_square) {
+    if (ep_square < 64) {
+        int file = ep_square % 8;
+        current_hash ^= Zobrist::en_passant_keys[file];
+    }
+}
+
+void Position::hash_side() {
+    current_hash ^= Zobrist::side_key;
+}
+
+bool Position::en_passant_capturable(uint8_t ep_square) const {
+    // The target is behind the pushed pawn, on the 6th rank for white to move
+    if (ep_square >= 64 || ep_square / 8 != (turn == 0 ? 5 : 2)) return false;
+
+    const uint8_t pushed_sq = (turn == 0) ? ep_square - 8 : ep_square + 8;
+    const uint8_t capturer = MAKE_PIECE(PIECE_PAWN, turn == 0 ? COLOR_WHITE : COLOR_BLACK);
+    const int file = pushed_sq % 8;
+    return (file > 0 && squares[pushed_sq - 1] == capturer) ||
+           (file < 7 && squares[pushed_sq + 1] == capturer);
+}
+
+uint64_t Position::calculate_hash() const {
+    uint64_t hash = 0;
+    
+    for (int sq = 0; sq < 64; sq++) {
+        uint8_t piece = squares[sq];
+        if (!IS_EMPTY(piece)) {
+            int piece_index = get_zobrist_piece_index(piece);
+            if (piece_index >= 0) {
+                hash ^= Zobrist::piece_keys[piece_index][sq];
+            }
+        }
+    }
+    
+    hash ^= Zobrist::castling_keys[castling_rights];
+    
+    if (en_passant_target < 64) {
+        int file = en_passant_target % 8;
+        hash ^= Zobrist::en_passant_keys[file];
+    }
+    
+    if (turn == 1) {
+        hash ^= Zobrist::side_key;
+    }
+    
+    return hash;
+}
+
+// ==================== BOARD SETUP / FEN ====================
+
+void Position::clear_board() {
+    memset(squares, 0, sizeof(squares));
+    memset(piece_index, 0, sizeof(piece_index));
+    white_king_pos = 255;
+    black_king_pos = 255;
+    white_piece_count = 0;
+    black_piece_count = 0;
+    current_hash = 0;
+    turn = 0;
+    castling_rights = 0;
+    en_passant_target = 255;
+    halfmove_clock = 0;
+    fullmove_number = 1;
+}
+
+void Position::rebuild_piece_lists() {
+    white_piece_count = 0;
+    black_piece_count = 0;
+
+    for (uint8_t sq = 0; sq < 64; sq++) {
+        uint8_t piece = squares[sq];
+        if (!IS_EMPTY(piece)) {
+            add_piece_to_list(sq, piece);
+        }
+    }
+}
+
+void Position::update_king_cache() {
+    white_king_pos = 255;
+    black_king_pos = 255;
+    for (int i = 0; i < 64; i++) {
+        if (GET_PIECE_TYPE(squares[i]) == PIECE_KING) {
+            if (IS_WHITE(squares[i])) white_king_pos = i;
+            else black_king_pos = i;
+        }
+    }
+}
+
+void Position::initialize_starting_position() {
+    clear_board();
+    
+    squares[0] = MAKE_PIECE(PIECE_ROOK, COLOR_WHITE);
+    squares[1] = MAKE_PIECE(PIECE_KNIGHT, COLOR_WHITE);
+    squares[2] = MAKE_PIECE(PIECE_BISHOP, COLOR_WHITE);
+    squares[3] = MAKE_PIECE(PIECE_QUEEN, COLOR_WHITE);
+    squares[4] = MAKE_PIECE(PIECE_KING, COLOR_WHITE);
+    squares[5] = MAKE_PIECE(PIECE_BISHOP, COLOR_WHITE);
+    squares[6] = MAKE_PIECE(PIECE_KNIGHT, COLOR_WHITE);
+    squares[7] = MAKE_PIECE(PIECE_ROOK, COLOR_WHITE);
+    
+    for (int i = 8; i < 16; i++) {
+        squares[i] = MAKE_PIECE(PIECE_PAWN, COLOR_WHITE);
+    }
+    
+    for (int i = 48; i < 56; i++) {
+        squares[i] = MAKE_PIECE(PIECE_PAWN, COLOR_BLACK);
+    }
+    
+    squares[56] = MAKE_PIECE(PIECE_ROOK, COLOR_BLACK);
+    squares[57] = MAKE_PIECE(PIECE_KNIGHT, COLOR_BLACK);
+    squares[58] = MAKE_PIECE(PIECE_BISHOP, COLOR_BLACK);
+    squares[59] = MAKE_PIECE(PIECE_QUEEN, COLOR_BLACK);
+    squares[60] = MAKE_PIECE(PIECE_KING, COLOR_BLACK);
+    squares[61] = MAKE_PIECE(PIECE_BISHOP, COLOR_BLACK);
+    squares[62] = MAKE_PIECE(PIECE_KNIGHT, COLOR_BLACK);
+    squares[63] = MAKE_PIECE(PIECE_ROOK, COLOR_BLACK);
+    
+    turn = 0;
+    castling_rights = CASTLE_ALL;
+    en_passant_target = 255;
+    halfmove_clock = 0;
+    fullmove_number = 1;
+    white_king_pos = 4;
+    black_king_pos = 60;
+
+    rebuild_piece_lists();
+    current_hash = calculate_hash();
+}
+
+// Splits off the next space-delimited field of text (empty when exhausted)
+static std::string_view next_field(std::string_view &text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        text = std::string_view();
+        return text;
+    }
+    size_t end = text.find_first_of(" \t", start);
+    if (end == std::string_view::npos) end = text.size();
+
+    std::string_view field = text.substr(start, end - start);
+    text.remove_prefix(end);
+    return field;
+}
+
+// Parses a non-negative decimal field, false if it isn't one
+static bool parse_uint(std::string_view field, uint64_t &value) {
+    if (field.empty()) return false;
+    value = 0;
+    for (char c : field) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+static uint8_t piece_from_char(char c) {
+    uint8_t color = (c >= 'A' && c <= 'Z') ? COLOR_WHITE : COLOR_BLACK;
+    switch (c | 32) {
+        case 'p': return MAKE_PIECE(PIECE_PAWN, color);
+        case 'n': return MAKE_PIECE(PIECE_KNIGHT, color);
+        case 'b': return MAKE_PIECE(PIECE_BISHOP, color);
+        case 'r': return MAKE_PIECE(PIECE_ROOK, color);
+        case 'q': return MAKE_PIECE(PIECE_QUEEN, color);
+        case 'k': return MAKE_PIECE(PIECE_KING, color);
+    }
+    return PIECE_NONE;
+}
+
+uint8_t Position::parse_square(std::string_view text) {
+    if (text.size() < 2) return 255;
+
+    int file = text[0] - 'a';
+    int rank = text[1] - '1';
+    if (file < 0 || file > 7 || rank < 0 || rank > 7) return 255;
+
+    return rank * 8 + file;
+}
+
+void Position::square_name(uint8_t square, char out[3]) {
+    if (square >= 64) {
+        out[0] = '-';
+        out[1] = 0;
+        return;
+    }
+    out[0] = 'a' + square % 8;
+    out[1] = '1' + square / 8;
+    out[2] = 0;
+}
+
+bool Position::parse_fen(std::string_view fen) {
+    clear_board();
+
+    std::string_view rest = fen;
+    std::string_view placement = next_field(rest);
+    std::string_view side = next_field(rest);
+    std::string_view castling = next_field(rest);
+    std::string_view ep = next_field(rest);
+    if (placement.empty() || side.empty()) {
+        clear_board();
+        return false;
+    }
+
+    // Placement: ranks 8..1, files a..h
+    int rank = 7;
+    int file = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) break;
+            rank--;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+        } else {
+            uint8_t piece = piece_from_char(c);
+            if (piece == PIECE_NONE || file > 7) break;
+            squares[rank * 8 + file] = piece;
+            file++;
+        }
+
+        if (file > 8) break;
+    }
+    if (rank != 0 || file != 8) {
+        clear_board();
+        return false;
+    }
+
+    if (side == "w") turn = 0;
+    else if (side == "b") turn = 1;
+    else {
+        clear_board();
+        return false;
+    }
+
+    for (char c : castling) {
+        if (c == 'K') castling_rights |= CASTLE_WHITE_KINGSIDE;
+        if (c == 'Q') castling_rights |= CASTLE_WHITE_QUEENSIDE;
+        if (c == 'k') castling_rights |= CASTLE_BLACK_KINGSIDE;
+        if (c == 'q') castling_rights |= CASTLE_BLACK_QUEENSIDE;
+    }
+
+    // FENs conventionally name the square after every double push; keep it
+    // only when it matters so the hash matches the same position reached by moves
+    en_passant_target = (ep.empty() || ep == "-") ? 255 : parse_square(ep);
+    if (en_passant_target != 255 && !en_passant_capturable(en_passant_target)) {
+        en_passant_target = 255;
+    }
+
+    // Optional clocks (absent in EPD, where opcodes follow instead)
+    uint64_t value;
+    std::string_view clocks = rest;
+    if (parse_uint(next_field(clocks), value)) {
+        halfmove_clock = value > 255 ? 255 : static_cast<uint8_t>(value);
+        if (parse_uint(next_field(clocks), value) && value > 0) {
+            fullmove_number = static_cast<uint16_t>(value);
+        }
+    }
+
+    update_king_cache();
+    rebuild_piece_lists();
+    current_hash = calculate_hash();
+
+    return true;
+}
+
+std::string Position::to_fen() const {
+    std::string fen;
+    fen.reserve(90);
+
+    static const char PIECE_CHARS[7] = {'.', 'p', 'n', 'b', 'r', 'q', 'k'};
+
+    for (int rank = 7; rank >= 0; rank--) {
+        int empty_count = 0;
+
+        for (int file = 0; file < 8; file++) {
+            uint8_t piece = squares[rank * 8 + file];
+
+            if (IS_EMPTY(piece)) {
+                empty_count++;
+                continue;
+            }
+            if (empty_count > 0) {
+                fen += static_cast<char>('0' + empty_count);
+                empty_count = 0;
+            }
+
+            char piece_char = PIECE_CHARS[GET_PIECE_TYPE(piece)];
+            if (IS_WHITE(piece)) piece_char -= 32;
+            fen += piece_char;
+        }
+
+        if (empty_count > 0) fen += static_cast<char>('0' + empty_count);
+        if (rank > 0) fen += '/';
+    }
+
+    fen += (turn == 0) ? " w " : " b ";
+
+    size_t castling_start = fen.size();
+    if (castling_rights & CASTLE_WHITE_KINGSIDE) fen += 'K';
+    if (castling_rights & CASTLE_WHITE_QUEENSIDE) fen += 'Q';
+    if (castling_rights & CASTLE_BLACK_KINGSIDE) fen += 'k';
+    if (castling_rights & CASTLE_BLACK_QUEENSIDE) fen += 'q';
+    if (fen.size() == castling_start) fen += '-';
+
+    char ep[3];
+    square_name(en_passant_target, ep);
+    fen += ' ';
+    fen += ep;
+
+    fen += ' ' + std::to_string(halfmove_clock);
+    fen += ' ' + std::to_string(fullmove_number);
+
+    return fen;
+}
+
+// ==================== SIDE CONSTANTS ====================
+
+// Compile-time constants of one side; Us follows `turn` (0 = white, 1 = black)
+template <uint8_t Us> struct Side;
+
+template <> struct Side<0> {
+    static constexpr uint8_t COLOR = COLOR_WHITE;
+    static constexpr uint8_t THEM_COLOR = COLOR_BLACK;
+    static constexpr int PAWN_PUSH = 8;
+    static constexpr int START_RANK = 1;
+    static constexpr int PROMO_RANK = 7;
+    static constexpr uint8_t KING_HOME = 4;
+    static constexpr uint8_t ROOK_KINGSIDE = 7;
+    static constexpr uint8_t ROOK_QUEENSIDE = 0;
+    static constexpr uint8_t CASTLE_KINGSIDE = CASTLE_WHITE_KINGSIDE;
+    static constexpr uint8_t CASTLE_QUEENSIDE = CASTLE_WHITE_QUEENSIDE;
+};
+
+template <> struct Side<1> {
+    static constexpr uint8_t COLOR = COLOR_BLACK;
+    static constexpr uint8_t THEM_COLOR = COLOR_WHITE;
+    static constexpr int PAWN_PUSH = -8;
+    static constexpr int START_RANK = 6;
+    static constexpr int PROMO_RANK = 0;
+    static constexpr uint8_t KING_HOME = 60;
+    static constexpr uint8_t ROOK_KINGSIDE = 63;
+    static constexpr uint8_t ROOK_QUEENSIDE = 56;
+    static constexpr uint8_t CASTLE_KINGSIDE = CASTLE_BLACK_KINGSIDE;
+    static constexpr uint8_t CASTLE_QUEENSIDE = CASTLE_BLACK_QUEENSIDE;
+};
+
+// ==================== ATTACK DETECTION ====================
+
+template <uint8_t Them>
+bool Position::square_attacked_by(uint8_t pos) const {
+    constexpr uint8_t attacker_color = Side<Them>::COLOR;
+    
+    // Knight attacks
+    for (int i = 0; i < knight_attack_count[pos]; i++) {
+        if (squares[knight_attack_squares[pos][i]] == MAKE_PIECE(PIECE_KNIGHT, attacker_color)) {
+            return true;
+        }
+    }
+    
+    // King attacks
+    for (int i = 0; i < king_attack_count[pos]; i++) {
+        if (squares[king_attack_squares[pos][i]] == MAKE_PIECE(PIECE_KING, attacker_color)) {
+            return true;
+        }
+    }
+    
+    // Pawn attacks come from one rank behind the square, seen from the attacker
+    constexpr int pawn_dir = -Side<Them>::PAWN_PUSH;
+    int file = pos % 8;
+    
+    if (file > 0) {
+        int sq = pos + pawn_dir - 1;
+        if (sq >= 0 && sq < 64 && squares[sq] == MAKE_PIECE(PIECE_PAWN, attacker_color)) {
+            return true;
+        }
+    }
+    if (file < 7) {
+        int sq = pos + pawn_dir + 1;
+        if (sq >= 0 && sq < 64 && squares[sq] == MAKE_PIECE(PIECE_PAWN, attacker_color)) {
+            return true;
+        }
+    }
+    
+    // Sliding pieces
+    for (int dir = 0; dir < 8; dir++) {
+        int offset = DIR_OFFSETS[dir];
+        int dist = squares_to_edge[pos][dir];
+        int sq = pos;
+        
+        for (int d = 0; d < dist; d++) {
+            sq += offset;
+            uint8_t piece = squares[sq];
+            
+            if (!IS_EMPTY(piece)) {
+                if (GET_COLOR(piece) == attacker_color) {
+                    uint8_t type = GET_PIECE_TYPE(piece);
+                    if (type == PIECE_QUEEN) return true;
+                    if (dir < 4 && type == PIECE_ROOK) return true;
+                    if (dir >= 4 && type == PIECE_BISHOP) return true;
+                }
+                break;
+            }
+        }
+    }
+    
+    return false;
+}
+
+bool Position::is_square_attacked_fast(uint8_t pos, uint8_t attacking_color) const {
+    return (attacking_color == 0) ? square_attacked_by<0>(pos) : square_attacked_by<1>(pos);
+}
+
+bool Position::is_king_in_check(uint8_t color) const {
+    uint8_t king_pos = (color == 0) ? white_king_pos : black_king_pos;
+    if (king_pos == 255) return false;
+    return is_square_attacked_fast(king_pos, 1 - color);
+}
+
+template <uint8_t Us>
+bool Position::has_legal_moves_for() {
+    MoveList moves;
+    generate_pseudo_legal<Us>(moves);
+    
+    uint8_t ep_before = en_passant_target;
+    uint8_t castling_before = castling_rights;
+    uint64_t hash_before = current_hash;
+    
+    for (int i = 0; i < moves.count; i++) {
+        FastMove &m = moves.moves[i];
+        
+        make_move<Us>(m);
+        bool legal = !square_attacked_by<1 - Us>(king_pos_of<Us>());
+        unmake_move<Us>(m, ep_before, castling_before, hash_before);
+        
+        if (legal) return true;
+    }
+    
+    return false;
+}
+
+bool Position::has_legal_moves() const {
+    // Moves are made and unmade, the position is unchanged afterwards
+    Position* self = const_cast<Position*>(this);
+    return (turn == 0) ? self->has_legal_moves_for<0>() : self->has_legal_moves_for<1>();
+}
+
+template <uint8_t Us>
+void Position::generate_legal(MoveList &moves) {
+    MoveList pseudo;
+    generate_pseudo_legal<Us>(pseudo);
+    moves.clear();
+    
+    uint8_t ep_before = en_passant_target;
+    uint8_t castling_before = castling_rights;
+    uint64_t hash_before = current_hash;
+    
+    for (int i = 0; i < pseudo.count; i++) {
+        FastMove &m = pseudo.moves[i];
+        
+        make_move<Us>(m);
+        if (!square_attacked_by<1 - Us>(king_pos_of<Us>())) {
+            moves.moves[moves.count++] = m;
+        }
+        unmake_move<Us>(m, ep_before, castling_before, hash_before);
+    }
+}
+
+void Position::generate_legal_moves(MoveList &moves) {
+    if (turn == 0) generate_legal<0>(moves);
+    else generate_legal<1>(moves);
+}
+
+// ==================== DRAWS BY MATERIAL ====================
+
+// Minor pieces of one side. False if it has a pawn, rook or queen
+struct MinorPieces {
+    int knights = 0;
+    int bishops = 0;
+    uint8_t bishop_square_colors = 0;   // Bit 0: a dark-squared bishop, bit 1: a light-squared one
+};
+
+static bool count_minor_pieces(const uint8_t *squares, const uint8_t *list, uint8_t count, MinorPieces &minors) {
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t sq = list[i];
+        switch (GET_PIECE_TYPE(squares[sq])) {
+            case PIECE_KING: break;
+            case PIECE_KNIGHT: minors.knights++; break;
+            case PIECE_BISHOP:
+                minors.bishops++;
+                minors.bishop_square_colors |= 1 << (((sq / 8) + (sq % 8)) & 1);
+                break;
+            default: return false;
+        }
+    }
+    return true;
+}
+
+// Shared by both checks: false (and nothing counted) for more than four pieces
+static bool minor_piece_endgame(const Position &pos, MinorPieces &white, MinorPieces &black) {
+    if (pos.white_piece_count + pos.black_piece_count > 4) return false;
+    return count_minor_pieces(pos.squares, pos.white_piece_list, pos.white_piece_count, white) &&
+           count_minor_pieces(pos.squares, pos.black_piece_list, pos.black_piece_count, black);
+}
+
+bool Position::is_insufficient_material() const {
+    MinorPieces white, black;
+    if (!minor_piece_endgame(*this, white, black)) return false;
+
+    const int knights = white.knights + black.knights;
+    const int bishops = white.bishops + black.bishops;
+    if (knights + bishops <= 1) return true;
+
+    // Bishops only, all on one square colour
+    const uint8_t colors = white.bishop_square_colors | black.bishop_square_colors;
+    return knights == 0 && colors != 3;
+}
+
+bool Position::is_drawish_material() const {
+    MinorPieces white, black;
+    if (!minor_piece_endgame(*this, white, black)) return false;
+
+    // A side can't force mate with one minor piece or two knights
+    auto cannot_win = [](const MinorPieces &side) {
+        return side.knights + side.bishops <= 1 || (side.knights == 2 && side.bishops == 0);
+    };
+    return (cannot_win(white) && cannot_win(black)) || is_insufficient_material();
+}
+
+// ==================== MOVE GENERATION ====================
+
+template <uint8_t Us>
+inline void Position::generate_pawn_moves(uint8_t pos, MoveList &moves) const {
+    constexpr int direction = Side<Us>::PAWN_PUSH;
+    int rank = pos / 8;
+    int file = pos % 8;
+    
+    int to = pos + direction;
+    if (to >= 0 && to < 64 && IS_EMPTY(squares[to])) {
+        if (to / 8 == Side<Us>::PROMO_RANK) {
+            moves.add(pos, to, (PIECE_QUEEN << 3), 0);
+            moves.add(pos, to, (PIECE_ROOK << 3), 0);
+            moves.add(pos, to, (PIECE_BISHOP << 3), 0);
+            moves.add(pos, to, (PIECE_KNIGHT << 3), 0);
+        } else {
+            moves.add(pos, to);
+        }
+        
+        if (rank == Side<Us>::START_RANK) {
+            int to2 = pos + 2 * direction;
+            if (IS_EMPTY(squares[to2])) {
+                moves.add(pos, to2);
+            }
+        }
+    }
+    
+    // Captures towards the a-file (delta -1) and the h-file (delta +1)
+    for (int delta = -1; delta <= 1; delta += 2) {
+        if ((delta < 0 && file == 0) || (delta > 0 && file == 7)) continue;
+        
+        int to_sq = pos + direction + delta;
+        if (to_sq < 0 || to_sq >= 64) continue;
+        
+        uint8_t target = squares[to_sq];
+        if (GET_COLOR(target) == Side<Us>::THEM_COLOR) {
+            if (to_sq / 8 == Side<Us>::PROMO_RANK) {
+                moves.add(pos, to_sq, 1 | (PIECE_QUEEN << 3), target);
+                moves.add(pos, to_sq, 1 | (PIECE_ROOK << 3), target);
+                moves.add(pos, to_sq, 1 | (PIECE_BISHOP << 3), target);
+                moves.add(pos, to_sq, 1 | (PIECE_KNIGHT << 3), target);
+            } else {
+                moves.add(pos, to_sq, 1, target);
+            }
+        }
+        else if (to_sq == en_passant_target) {
+            int captured_sq = to_sq - direction;
+            moves.add(pos, to_sq, 2, squares[captured_sq]);
+        }
+    }
+}
+
+template <uint8_t Us>
+inline void Position::generate_step_moves(uint8_t pos, const uint8_t (&targets)[64][8], const uint8_t (&target_count)[64], MoveList &moves) const {
+    for (int i = 0; i < target_count[pos]; i++) {
+        uint8_t to = targets[pos][i];
+        uint8_t target = squares[to];
+        
+        if (IS_EMPTY(target)) {
+            moves.add(pos, to);
+        } else if (GET_COLOR(target) == Side<Us>::THEM_COLOR) {
+            moves.add(pos, to, 1, target);
+        }
+    }
+}
+
+// Directions [first_dir, last_dir) of DIR_OFFSETS: 0-4 orthogonal, 4-8 diagonal
+template <uint8_t Us>
+inline void Position::generate_slider_moves(uint8_t pos, int first_dir, int last_dir, MoveList &moves) const {
+    for (int dir = first_dir; dir < last_dir; dir++) {
+        int offset = DIR_OFFSETS[dir];
+        int dist = squares_to_edge[pos][dir];
+        int sq = pos;
+        
+        for (int d = 0; d < dist; d++) {
+            sq += offset;
+            uint8_t target = squares[sq];
+            
+            if (IS_EMPTY(target)) {
+                moves.add(pos, sq);
+            } else {
+                if (GET_COLOR(target) == Side<Us>::THEM_COLOR) {
+                    moves.add(pos, sq, 1, target);
+                }
+                break;
+            }
+        }
+    }
+}
+
+template <uint8_t Us>
+inline void Position::generate_castling_moves(uint8_t pos, MoveList &moves) const {
+    constexpr uint8_t king_pos = Side<Us>::KING_HOME;
+    constexpr uint8_t them = 1 - Us;
+    if (pos != king_pos) return;
+    
+    if ((castling_rights & Side<Us>::CASTLE_KINGSIDE) &&
+        IS_EMPTY(squares[king_pos + 1]) && 
+        IS_EMPTY(squares[king_pos + 2]) &&
+        !square_attacked_by<them>(king_pos) &&
+        !square_attacked_by<them>(king_pos + 1) &&
+        !square_attacked_by<them>(king_pos + 2)) {
+        moves.add(pos, pos + 2, 4);
+    }
+    
+    if ((castling_rights & Side<Us>::CASTLE_QUEENSIDE) &&
+        IS_EMPTY(squares[king_pos - 1]) && 
+        IS_EMPTY(squares[king_pos - 2]) &&
+        IS_EMPTY(squares[king_pos - 3]) &&
+        !square_attacked_by<them>(king_pos) &&
+        !square_attacked_by<them>(king_pos - 1) &&
+        !square_attacked_by<them>(king_pos - 2)) {
+        moves.add(pos, pos - 2, 4);
+    }
+}
+
+template <uint8_t Us>
+void Position::generate_pseudo_legal(MoveList &moves) const {
+    moves.clear();
+
+    // Use piece lists for faster iteration (avoid scanning empty squares)
+    const uint8_t* piece_list = (Us == 0) ? white_piece_list : black_piece_list;
+    const uint8_t piece_count = (Us == 0) ? white_piece_count : black_piece_count;
+
+    for (uint8_t i = 0; i < piece_count; i++) {
+        uint8_t sq = piece_list[i];
+
+        switch (GET_PIECE_TYPE(squares[sq])) {
+            case PIECE_PAWN:   generate_pawn_moves<Us>(sq, moves); break;
+            case PIECE_KNIGHT: generate_step_moves<Us>(sq, knight_attack_squares, knight_attack_count, moves); break;
+            case PIECE_BISHOP: generate_slider_moves<Us>(sq, 4, 8, moves); break;
+            case PIECE_ROOK:   generate_slider_moves<Us>(sq, 0, 4, moves); break;
+            case PIECE_QUEEN:  generate_slider_moves<Us>(sq, 0, 8, moves); break;
+            case PIECE_KING:
+                generate_step_moves<Us>(sq, king_attack_squares, king_attack_count, moves);
+                generate_castling_moves<Us>(sq, moves);
+                break;
+        }
+    }
+}
+
+void Position::generate_all_pseudo_legal(MoveList &moves) const {
+    if (turn == 0) generate_pseudo_legal<0>(moves);
+    else generate_pseudo_legal<1>(moves);
+}
+
+// ==================== FAST MAKE/UNMAKE ====================
+
+template <uint8_t Us>
+void Position::make_move(const FastMove &m) {
+    constexpr uint8_t color = Side<Us>::COLOR;
+    uint8_t moving_piece = squares[m.from];
+    uint8_t piece_type = GET_PIECE_TYPE(moving_piece);
+    
+    if (en_passant_target < 64) {
+        hash_en_passant(en_passant_target);
+    }
+    
+    if (m.flags & 2) {
+        int capture_sq = m.to - Side<Us>::PAWN_PUSH;
+        hash_piece(squares[capture_sq], capture_sq);
+        remove_piece_from_list(capture_sq, squares[capture_sq]);
+        squares[capture_sq] = 0;
+    }
+    
+    if ((m.flags & 1) && !(m.flags & 2)) {
+        hash_piece(squares[m.to], m.to);
+        remove_piece_from_list(m.to, squares[m.to]);
+    }
+    
+    if (m.flags & 4) {
+        int move_dist = (int)m.to - (int)m.from;
+        if (move_dist == 2) {
+            hash_piece(squares[m.from + 3], m.from + 3);
+            hash_piece(squares[m.from + 3], m.from + 1);
+            move_piece_in_list(m.from + 3, m.from + 1, squares[m.from + 3]);
+            squares[m.from + 1] = squares[m.from + 3];
+            squares[m.from + 3] = 0;
+        } else {
+            hash_piece(squares[m.from - 4], m.from - 4);
+            hash_piece(squares[m.from - 4], m.from - 1);
+            move_piece_in_list(m.from - 4, m.from - 1, squares[m.from - 4]);
+            squares[m.from - 1] = squares[m.from - 4];
+            squares[m.from - 4] = 0;
+        }
+    }
+    
+    hash_piece(moving_piece, m.from);
+    move_piece_in_list(m.from, m.to, moving_piece);
+    
+    squares[m.to] = moving_piece;
+    squares[m.from] = 0;
+    
+    uint8_t promo_piece = (m.flags >> 3) & 7;
+    if (promo_piece) {
+        squares[m.to] = MAKE_PIECE(promo_piece, color);
+        hash_piece(squares[m.to], m.to);
+    } else {
+        hash_piece(moving_piece, m.to);
+    }
+    
+    en_passant_target = 255;
+    if (piece_type == PIECE_PAWN) {
+        // Only worth an en passant square if one of their pawns is beside ours
+        constexpr uint8_t their_pawn = MAKE_PIECE(PIECE_PAWN, Side<Us>::THEM_COLOR);
+        const int file = m.to % 8;
+        if (m.to == m.from + 2 * Side<Us>::PAWN_PUSH &&
+            ((file > 0 && squares[m.to - 1] == their_pawn) || (file < 7 && squares[m.to + 1] == their_pawn))) {
+            en_passant_target = (m.from + m.to) / 2;
+            hash_en_passant(en_passant_target);
+        }
+    } else if (piece_type == PIECE_KING) {
+        king_pos_of<Us>() = m.to;
+    }
+    
+    // King moves, rooks leaving or captured on their corners (one XOR pair even if unchanged)
+    const uint8_t rights = castling_rights & castling_mask[m.from] & castling_mask[m.to];
+    hash_castling(castling_rights, rights);
+    castling_rights = rights;
+    
+    hash_side();
+    turn = 1 - turn;
+    VERIFY_STATE("make_move_fast");
+}
+
+template <uint8_t Us>
+void Position::unmake_move(const FastMove &m, uint8_t ep_before, uint8_t castling_before, uint64_t hash_before) {
+    uint8_t promo_piece = (m.flags >> 3) & 7;
+    uint8_t moving_piece = promo_piece ? MAKE_PIECE(PIECE_PAWN, Side<Us>::COLOR) : squares[m.to];
+    
+    squares[m.from] = moving_piece;
+    squares[m.to] = (m.flags & 2) ? 0 : m.captured;
+    move_piece_in_list(m.to, m.from, moving_piece);
+    
+    if (m.flags & 2) {
+        int capture_sq = m.to - Side<Us>::PAWN_PUSH;
+        squares[capture_sq] = m.captured;
+        add_piece_to_list(capture_sq, m.captured);
+    } else if (m.flags & 1) {
+        add_piece_to_list(m.to, m.captured);
+    }
+    
+    if (m.flags & 4) {
+        int move_dist = (int)m.to - (int)m.from;
+        if (move_dist == 2) {
+            move_piece_in_list(m.from + 1, m.from + 3, squares[m.from + 1]);
+            squares[m.from + 3] = squares[m.from + 1];
+            squares[m.from + 1] = 0;
+        } else {
+            move_piece_in_list(m.from - 1, m.from - 4, squares[m.from - 1]);
+            squares[m.from - 4] = squares[m.from - 1];
+            squares[m.from - 1] = 0;
+        }
+    }
+    
+    if (GET_PIECE_TYPE(moving_piece) == PIECE_KING) {
+        king_pos_of<Us>() = m.from;
+    }
+    
+    castling_rights = castling_before;
+    en_passant_target = ep_before;
+    current_hash = hash_before;
+    turn = 1 - turn;
+    VERIFY_STATE("unmake_move_fast");
+}
+
+void Position::make_move_fast(const FastMove &m) {
+    if (IS_WHITE(squares[m.from])) make_move<0>(m);
+    else make_move<1>(m);
+}
+
+void Position::unmake_move_fast(const FastMove &m, uint8_t ep_before, uint8_t castling_before, uint64_t hash_before) {
+    if (IS_WHITE(squares[m.to])) unmake_move<0>(m, ep_before, castling_before, hash_before);
+    else unmake_move<1>(m, ep_before, castling_before, hash_before);
+}
+
+// ==================== MAKE/UNMAKE WITH UNDO RECORD ====================
+
+void Position::make_move_internal(uint8_t from, uint8_t to, Move &move_record) {
+    uint8_t moving_piece = squares[from];
+    uint8_t piece_type = GET_PIECE_TYPE(moving_piece);
+    uint8_t color = GET_COLOR(moving_piece);
+    
+    move_record.from = from;
+    move_record.to = to;
+    move_record.captured_piece = squares[to];
+    move_record.promotion_piece = 0;
+    move_record.is_castling = false;
+    move_record.is_en_passant = false;
+    move_record.en_passant_target_before = en_passant_target;
+    move_record.halfmove_clock_before = halfmove_clock;
+    move_record.hash_before = current_hash;
+    move_record.castling_rights_before = castling_rights;
+    
+    if (en_passant_target < 64) {
+        hash_en_passant(en_passant_target);
+    }
+    
+    if (piece_type == PIECE_PAWN && to == en_passant_target) {
+        move_record.is_en_passant = true;
+        int capture_sq = to + ((color == COLOR_WHITE) ? -8 : 8);
+        move_record.captured_piece = squares[capture_sq];
+        hash_piece(squares[capture_sq], capture_sq);
+        remove_piece_from_list(capture_sq, squares[capture_sq]);
+        squares[capture_sq] = 0;
+    }
+    
+    if (!move_record.is_en_passant && !IS_EMPTY(squares[to])) {
+        hash_piece(squares[to], to);
+        remove_piece_from_list(to, squares[to]);
+    }
+    
+    if (piece_type == PIECE_KING) {
+        int move_dist = (int)to - (int)from;
+        
+        if (move_dist == 2) {
+            move_record.is_castling = true;
+            uint8_t rook = squares[from + 3];
+            hash_piece(rook, from + 3);
+            hash_piece(rook, from + 1);
+            move_piece_in_list(from + 3, from + 1, rook);
+            squares[from + 3] = 0;
+            squares[from + 1] = rook;
+        } else if (move_dist == -2) {
+            move_record.is_castling = true;
+            uint8_t rook = squares[from - 4];
+            hash_piece(rook, from - 4);
+            hash_piece(rook, from - 1);
+            move_piece_in_list(from - 4, from - 1, rook);
+            squares[from - 4] = 0;
+            squares[from - 1] = rook;
+        }
+    }
+    
+    hash_piece(moving_piece, from);
+    hash_piece(moving_piece, to);
+    move_piece_in_list(from, to, moving_piece);
+    
+    squares[to] = moving_piece;
+    squares[from] = 0;
+    
+    if (piece_type == PIECE_KING) {
+        if (color == COLOR_WHITE) white_king_pos = to;
+        else black_king_pos = to;
+    }
+    
+    en_passant_target = 255;
+    
+    const uint8_t rights = castling_rights & castling_mask[from] & castling_mask[to];
+    hash_castling(castling_rights, rights);
+    castling_rights = rights;
+    
+    if (piece_type == PIECE_PAWN || move_record.captured_piece != 0) {
+        halfmove_clock = 0;
+    } else {
+        halfmove_clock++;
+    }
+    
+    if (color == COLOR_BLACK) {
+        fullmove_number++;
+    }
+    
+    hash_side();
+    turn = 1 - turn;
+    
+    // After the turn flips: the capture has to be open to the side now to move
+    if (piece_type == PIECE_PAWN && (to == from + 16 || from == to + 16) && en_passant_capturable((from + to) / 2)) {
+        en_passant_target = (from + to) / 2;
+        hash_en_passant(en_passant_target);
+    }
+    VERIFY_STATE("make_move_internal");
+}
+
+void Position::revert_move_internal(const Move &move) {
+    uint8_t moving_piece = squares[move.to];
+    uint8_t color = GET_COLOR(moving_piece);
+    uint8_t piece_type = GET_PIECE_TYPE(moving_piece);
+    
+    if (move.promotion_piece != 0) {
+        moving_piece = MAKE_PIECE(PIECE_PAWN, color);
+    }
+    
+    squares[move.from] = moving_piece;
+    squares[move.to] = move.captured_piece;
+    move_piece_in_list(move.to, move.from, moving_piece);
+    
+    if (move.is_en_passant) {
+        squares[move.to] = 0;
+        int capture_sq = move.to + ((color == COLOR_WHITE) ? -8 : 8);
+        squares[capture_sq] = move.captured_piece;
+        add_piece_to_list(capture_sq, move.captured_piece);
+    } else if (!IS_EMPTY(move.captured_piece)) {
+        add_piece_to_list(move.to, move.captured_piece);
+    }
+    
+    if (move.is_castling) {
+        int move_dist = (int)move.to - (int)move.from;
+        if (move_dist == 2) {
+            uint8_t rook = squares[move.from + 1];
+            move_piece_in_list(move.from + 1, move.from + 3, rook);
+            squares[move.from + 1] = 0;
+            squares[move.from + 3] = rook;
+        } else {
+            uint8_t rook = squares[move.from - 1];
+            move_piece_in_list(move.from - 1, move.from - 4, rook);
+            squares[move.from - 1] = 0;
+            squares[move.from - 4] = rook;
+        }
+    }
+    
+    if (GET_PIECE_TYPE(moving_piece) == PIECE_KING) {
+        if (color == COLOR_WHITE) white_king_pos = move.from;
+        else black_king_pos = move.from;
+    }
+    
+    castling_rights = move.castling_rights_before;
+    
+    en_passant_target = move.en_passant_target_before;
+    halfmove_clock = move.halfmove_clock_before;
+    current_hash = move.hash_before;
+    
+    turn = 1 - turn;
+    
+    if (color == COLOR_BLACK) {
+        fullmove_number--;
+    }
+    VERIFY_STATE("revert_move_internal");
+}
+
+// ==================== SAN ====================
+
+bool Position::parse_san(std::string_view san, FastMove &move) {
+    // Drop check/mate marks and annotations ("+", "#", "!", "?")
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+    if (san.size() < 2) return false;
+
+    uint8_t piece_type = PIECE_PAWN;
+    uint8_t promotion = 0;
+    int from_file = -1;
+    int from_rank = -1;
+    uint8_t to = 255;
+    uint8_t king_from = (turn == 0) ? 4 : 60;
+
+    if (san == "O-O" || san == "0-0") {
+        piece_type = PIECE_KING;
+        to = king_from + 2;
+    } else if (san == "O-O-O" || san == "0-0-0") {
+        piece_type = PIECE_KING;
+        to = king_from - 2;
+    } else {
+        switch (san[0]) {
+            case 'N': piece_type = PIECE_KNIGHT; break;
+            case 'B': piece_type = PIECE_BISHOP; break;
+            case 'R': piece_type = PIECE_ROOK; break;
+            case 'Q': piece_type = PIECE_QUEEN; break;
+            case 'K': piece_type = PIECE_KING; break;
+        }
+        if (piece_type != PIECE_PAWN) san.remove_prefix(1);
+
+        // Promotion suffix: "=Q" (or a bare "Q" as some writers emit)
+        if (piece_type == PIECE_PAWN && san.size() >= 3) {
+            char last = san.back();
+            switch (last) {
+                case 'N': promotion = PIECE_KNIGHT; break;
+                case 'B': promotion = PIECE_BISHOP; break;
+                case 'R': promotion = PIECE_ROOK; break;
+                case 'Q': promotion = PIECE_QUEEN; break;
+            }
+            if (promotion) {
+                san.remove_suffix(1);
+                if (!san.empty() && san.back() == '=') san.remove_suffix(1);
+            }
+        }
+
+        // Destination is always the last two characters
+        if (san.size() < 2) return false;
+        to = parse_square(san.substr(san.size() - 2));
+        if (to == 255) return false;
+        san.remove_suffix(2);
+
+        // What remains is optional disambiguation plus an optional capture mark
+        for (char c : san) {
+            if (c >= 'a' && c <= 'h') from_file = c - 'a';
+            else if (c >= '1' && c <= '8') from_rank = c - '1';
+            else if (c != 'x' && c != ':') return false;
+        }
+    }
+
+    MoveList moves;
+    generate_all_pseudo_legal(moves);
+
+    uint8_t current_color = turn;
+    uint8_t ep_before = en_passant_target;
+    uint8_t castling_before = castling_rights;
+    uint64_t hash_before = current_hash;
+
+    int matches = 0;
+    for (int i = 0; i < moves.count; i++) {
+        const FastMove &m = moves.moves[i];
+        if (m.to != to || GET_PIECE_TYPE(squares[m.from]) != piece_type) continue;
+        if (((m.flags >> 3) & 7) != promotion) continue;
+        if (from_file >= 0 && m.from % 8 != from_file) continue;
+        if (from_rank >= 0 && m.from / 8 != from_rank) continue;
+
+        // Only candidates pay for the legality check
+        make_move_fast(m);
+        uint8_t our_king = (current_color == 0) ? white_king_pos : black_king_pos;
+        bool legal = !is_square_attacked_fast(our_king, 1 - current_color);
+        unmake_move_fast(m, ep_before, castling_before, hash_before);
+
+        if (legal) {
+            move = m;
+            matches++;
+        }
+    }
+
+    return matches == 1;
+}
+
+void Position::play_move(const FastMove &m) {
+    Move record;
+    make_move_internal(m.from, m.to, record);
+
+    uint8_t promo_piece = (m.flags >> 3) & 7;
+    if (promo_piece) {
+        uint8_t color = GET_COLOR(squares[m.to]);
+        hash_piece(squares[m.to], m.to);
+        squares[m.to] = MAKE_PIECE(promo_piece, color);
+        hash_piece(squares[m.to], m.to);
+        VERIFY_STATE("play_move");
+    }
+}
+
+Position Position::after(const FastMove &m) const {
+    Position child = *this;
+    child.make_move_fast(m);
+    return child;
+}
+
+// ==================== PERFT ====================
+
+template <uint8_t Us>
+uint64_t Position::perft(uint8_t depth) {
+    if (depth == 0) return 1;
+    
+    MoveList moves;
+    generate_pseudo_legal<Us>(moves);
+    
+    uint64_t nodes = 0;
+    
+    uint8_t ep_before = en_passant_target;
+    uint8_t castling_before = castling_rights;
+    uint64_t hash_before = current_hash;
+    
+    for (int i = 0; i < moves.count; i++) {
+        FastMove &m = moves.moves[i];
+        
+        make_move<Us>(m);
+        if (!square_attacked_by<1 - Us>(king_pos_of<Us>())) {
+            nodes += perft<1 - Us>(depth - 1);
+        }
+        unmake_move<Us>(m, ep_before, castling_before, hash_before);
+    }
+    
+    return nodes;
+}
+
+uint64_t Position::count_all_moves(uint8_t depth) {
+    return (turn == 0) ? perft<0>(depth) : perft<1>(depth);
+}
+
+template <uint8_t Us>
+uint64_t Position::perft_copy(uint8_t depth) const {
+    if (depth == 0) return 1;
+    
+    MoveList moves;
+    generate_pseudo_legal<Us>(moves);
+    
+    uint64_t nodes = 0;
+    for (int i = 0; i < moves.count; i++) {
+        Position child = *this;
+        child.make_move<Us>(moves.moves[i]);
+        if (!child.square_attacked_by<1 - Us>(child.king_pos_of<Us>())) {
+            nodes += child.perft_copy<1 - Us>(depth - 1);
+        }
+    }
+    
+    return nodes;
+}
+
+uint64_t Position::count_all_moves_copy(uint8_t depth) const {
+    return (turn == 0) ? perft_copy<0>(depth) : perft_copy<1>(depth);
+}
+
+uint64_t Position::count_all_moves_parallel(uint8_t depth, int threads) const {
+    if (depth <= 1) return count_all_moves_copy(depth);
+    
+    MoveList moves;
+    Position root = *this;
+    root.generate_legal_moves(moves);
+    
+    if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, moves.count));
+    
+    // Workers claim root moves one at a time; the parent is only read
+    std::atomic<int> next_move(0);
+    std::atomic<uint64_t> total(0);
+    auto worker = [&]() {
+        uint64_t nodes = 0;
+        for (int i = next_move++; i < moves.count; i = next_move++) {
+            nodes += after(moves.moves[i]).count_all_moves_copy(depth - 1);
+        }
+        total += nodes;
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread &thread : pool) thread.join();
+    
+    return total.load();
+}
+
+// ==================== STATE VERIFICATION ====================
+
+// Formats a mismatch into error (if given) and returns false
+static bool state_mismatch(std::string *error, const char *what, int expected, int actual) {
+    if (error) {
+        *error = std::string(what) + ": expected " + std::to_string(expected) + ", found " + std::to_string(actual);
+    }
+    return false;
+}
+
+bool Position::verify_state(std::string *error) const {
+    if (turn > 1) return state_mismatch(error, "side to move", 0, turn);
+
+    // Hash
+    if (calculate_hash() != current_hash) {
+        if (error) *error = "hash differs from calculate_hash()";
+        return false;
+    }
+
+    // King cache
+    uint8_t white_king = 255;
+    uint8_t black_king = 255;
+    for (int sq = 0; sq < 64; sq++) {
+        if (GET_PIECE_TYPE(squares[sq]) == PIECE_KING) {
+            if (IS_WHITE(squares[sq])) white_king = sq;
+            else black_king = sq;
+        }
+    }
+    if (white_king != white_king_pos) return state_mismatch(error, "white king cache", white_king, white_king_pos);
+    if (black_king != black_king_pos) return state_mismatch(error, "black king cache", black_king, black_king_pos);
+
+    // Piece lists: every list entry points at a piece of its colour and back via
+    // piece_index, and the counts match the board
+    int white_count = 0;
+    int black_count = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        if (IS_EMPTY(squares[sq])) continue;
+        if (IS_WHITE(squares[sq])) white_count++;
+        else black_count++;
+    }
+    if (white_count != white_piece_count) return state_mismatch(error, "white piece count", white_count, white_piece_count);
+    if (black_count != black_piece_count) return state_mismatch(error, "black piece count", black_count, black_piece_count);
+
+    for (int i = 0; i < white_piece_count; i++) {
+        uint8_t sq = white_piece_list[i];
+        if (sq >= 64 || IS_EMPTY(squares[sq]) || !IS_WHITE(squares[sq])) return state_mismatch(error, "white piece list entry", i, sq);
+        if (piece_index[sq] != i) return state_mismatch(error, "piece_index of white square", sq, piece_index[sq]);
+    }
+    for (int i = 0; i < black_piece_count; i++) {
+        uint8_t sq = black_piece_list[i];
+        if (sq >= 64 || IS_EMPTY(squares[sq]) || IS_WHITE(squares[sq])) return state_mismatch(error, "black piece list entry", i, sq);
+        if (piece_index[sq] != i) return state_mismatch(error, "piece_index of black square", sq, piece_index[sq]);
+    }
+
+    // Castling rights need the king and rook on their home squares
+    static const uint8_t king_home[4] = {4, 4, 60, 60};
+    static const uint8_t rook_home[4] = {7, 0, 63, 56};
+    if (castling_rights > CASTLE_ALL) return state_mismatch(error, "castling rights bits", CASTLE_ALL, castling_rights);
+    for (int i = 0; i < 4; i++) {
+        if (!(castling_rights & (1 << i))) continue;
+        uint8_t color = (i < 2) ? COLOR_WHITE : COLOR_BLACK;
+        if (squares[king_home[i]] != MAKE_PIECE(PIECE_KING, color)) return state_mismatch(error, "castling right without king", i, squares[king_home[i]]);
+        if (squares[rook_home[i]] != MAKE_PIECE(PIECE_ROOK, color)) return state_mismatch(error, "castling right without rook", i, squares[rook_home[i]]);
+    }
+
+    // En passant target: empty square behind a pawn that just moved two squares
+    if (en_passant_target != 255) {
+        const bool white_moved = (turn == 1);
+        const int rank = en_passant_target / 8;
+        const int pawn_square = en_passant_target + (white_moved ? 8 : -8);
+        if (en_passant_target >= 64 || rank != (white_moved ? 2 : 5)) return state_mismatch(error, "en passant rank", white_moved ? 2 : 5, rank);
+        if (!IS_EMPTY(squares[en_passant_target])) return state_mismatch(error, "en passant square occupied", en_passant_target, squares[en_passant_target]);
+        if (squares[pawn_square] != MAKE_PIECE(PIECE_PAWN, white_moved ? COLOR_WHITE : COLOR_BLACK)) {
+            return state_mismatch(error, "en passant without pawn", pawn_square, squares[pawn_square]);
+        }
+        if (!en_passant_capturable(en_passant_target)) return state_mismatch(error, "en passant without capturer", 1, 0);
+    }
+
+    return true;
+}
+
+void Position::check_state(const char *where) const {
+    std::string error;
+    if (verify_state(&error)) return;
+
+    fprintf(stderr, "State verification failed after %s: %s\n  FEN: %s\n", where, error.c_str(), to_fen().c_str());
+    fflush(stderr);
+    abort();
+}
+
+// ==================== EPD ====================
+
+namespace Epd {
+
+// Stores one "opcode operand..." pair into ops (unknown opcodes are ignored)
+static void apply_opcode(std::string_view opcode, std::string_view operand, Position &pos, EpdOps *ops) {
+    // Strip surrounding quotes of string operands
+    if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+        operand = operand.substr(1, operand.size() - 2);
+    }
+
+    uint64_t value;
+    if (opcode == "hmvc") {
+        if (parse_uint(operand, value)) pos.halfmove_clock = value > 255 ? 255 : static_cast<uint8_t>(value);
+        return;
+    }
+    if (opcode == "fmvn") {
+        if (parse_uint(operand, value) && value > 0) pos.fullmove_number = static_cast<uint16_t>(value);
+        return;
+    }
+    if (!ops) return;
+
+    if (opcode == "id") ops->id.assign(operand);
+    else if (opcode == "c0") ops->comment.assign(operand);
+    else if (opcode == "bm") ops->best_moves.assign(operand);
+    else if (opcode == "am") ops->avoid_moves.assign(operand);
+    else if (opcode.size() == 2 && opcode[0] == 'D' && opcode[1] >= '1' && opcode[1] <= '0' + EPD_MAX_PERFT_DEPTH) {
+        if (parse_uint(operand, value)) ops->perft[opcode[1] - '0'] = value;
+    }
+}
+
+bool parse_line(std::string_view line, Position &pos, EpdOps *ops) {
+    if (ops) ops->clear();
+
+    // The position is the first four fields, plus the FEN clocks when present
+    std::string_view rest = line;
+    for (int i = 0; i < 4; i++) {
+        if (next_field(rest).empty()) return false;
+    }
+    std::string_view after_clocks = rest;
+    uint64_t value;
+    if (parse_uint(next_field(after_clocks), value)) {
+        rest = after_clocks;
+        std::string_view after_fullmove = rest;
+        if (parse_uint(next_field(after_fullmove), value)) rest = after_fullmove;
+    }
+
+    if (!pos.parse_fen(line.substr(0, line.size() - rest.size()))) return false;
+
+    // Operations: "opcode operand ... ;" with optional quoted operands
+    size_t i = 0;
+    while (i < rest.size()) {
+        while (i < rest.size() && (rest[i] == ' ' || rest[i] == '\t' || rest[i] == ';')) i++;
+        if (i >= rest.size()) break;
+
+        size_t opcode_start = i;
+        while (i < rest.size() && rest[i] != ' ' && rest[i] != '\t' && rest[i] != ';') i++;
+        std::string_view opcode = rest.substr(opcode_start, i - opcode_start);
+
+        while (i < rest.size() && (rest[i] == ' ' || rest[i] == '\t')) i++;
+        size_t operand_start = i;
+        bool in_quotes = false;
+        while (i < rest.size() && (in_quotes || rest[i] != ';')) {
+            if (rest[i] == '"') in_quotes = !in_quotes;
+            i++;
+        }
+
+        std::string_view operand = rest.substr(operand_start, i - operand_start);
+        while (!operand.empty() && (operand.back() == ' ' || operand.back() == '\t')) {
+            operand.remove_suffix(1);
+        }
+
+        apply_opcode(opcode, operand, pos, ops);
+    }
+
+    return true;
+}
+
+int64_t load_file(const char *path, std::vector<Position> &positions,
+                  std::vector<EpdOps> *ops, uint64_t *errors) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return -1;
+
+    // Rough reservation (~80 bytes per line) to avoid repeated regrowth
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long size = ftell(file);
+        if (size > 0) {
+            positions.reserve(positions.size() + size / 80);
+            if (ops) ops->reserve(ops->size() + size / 80);
+        }
+        fseek(file, 0, SEEK_SET);
+    }
+
+    // Read fixed-size chunks and parse every complete line in place
+    // (the partial last line is carried over to the next chunk)
+    const size_t CHUNK_SIZE = 1 << 20;
+    std::vector<char> buffer(CHUNK_SIZE);
+    size_t carried = 0;
+    int64_t loaded = 0;
+    uint64_t bad_lines = 0;
+    Position pos;
+    EpdOps line_ops;
+
+    auto handle_line = [&](std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string_view::npos || line[start] == '#') return;
+
+        if (!parse_line(line.substr(start), pos, ops ? &line_ops : nullptr)) {
+            bad_lines++;
+            return;
+        }
+        positions.push_back(pos);
+        if (ops) ops->push_back(line_ops);
+        loaded++;
+    };
+
+    while (true) {
+        if (carried == buffer.size()) buffer.resize(buffer.size() * 2);  // Line longer than a chunk
+        size_t read = fread(buffer.data() + carried, 1, buffer.size() - carried, file);
+        size_t available = carried + read;
+        if (available == 0) break;
+
+        std::string_view data(buffer.data(), available);
+        size_t line_start = 0;
+        size_t newline;
+        while ((newline = data.find('\n', line_start)) != std::string_view::npos) {
+            handle_line(data.substr(line_start, newline - line_start));
+            line_start = newline + 1;
+        }
+
+        carried = available - line_start;
+        if (read == 0) {
+            // End of file: the remainder is the last (unterminated) line
+            if (carried > 0) handle_line(data.substr(line_start));
+            break;
+        }
+        memmove(buffer.data(), buffer.data() + line_start, carried);
+    }
+
+    fclose(file);
+    if (errors) *errors = bad_lines;
+    return loaded;
+}
+
+} // namespace Epd
@@ -0,0 +1,368 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Piece type constants (lowest 3 bits)
+#define PIECE_NONE   0
+#define PIECE_PAWN   1
+#define PIECE_KNIGHT 2
+#define PIECE_BISHOP 3
+#define PIECE_ROOK   4
+#define PIECE_QUEEN  5
+#define PIECE_KING   6
+
+// Color constants (bits 3-4)
+#define COLOR_NONE  0
+#define COLOR_WHITE 8
+#define COLOR_BLACK 16
+
+// Masks for bitwise operations
+#define PIECE_TYPE_MASK 7
+#define COLOR_MASK      24
+
+// Castling rights bits (Position::castling_rights); the bit order matches the
+// KQkq order of FEN and the packed formats
+#define CASTLE_WHITE_KINGSIDE  1
+#define CASTLE_WHITE_QUEENSIDE 2
+#define CASTLE_BLACK_KINGSIDE  4
+#define CASTLE_BLACK_QUEENSIDE 8
+#define CASTLE_ALL             15
+
+// Incremental state verification: build with `scons verify=yes` (defines
+// CHESS_VERIFY_STATE) and every make/unmake recomputes the hash, king cache,
+// piece lists and castling/en passant plausibility from `squares`, aborting
+// with a diagnostic on the first mismatch. Compiles to nothing otherwise
+#ifdef CHESS_VERIFY_STATE
+#define VERIFY_STATE(where) check_state(where)
+#else
+#define VERIFY_STATE(where) ((void)0)
+#endif
+
+// Helper macros - inline for performance
+#define GET_PIECE_TYPE(square) ((square) & PIECE_TYPE_MASK)
+#define GET_COLOR(square) ((square) & COLOR_MASK)
+#define MAKE_PIECE(type, color) ((type) | (color))
+#define IS_EMPTY(square) (((square) & PIECE_TYPE_MASK) == 0)
+#define IS_WHITE(square) (((square) & COLOR_MASK) == COLOR_WHITE)
+#define IS_BLACK(square) (((square) & COLOR_MASK) == COLOR_BLACK)
+
+// Direction constants
+#define DIR_N   8
+#define DIR_S  -8
+#define DIR_E   1
+#define DIR_W  -1
+#define DIR_NE  9
+#define DIR_NW  7
+#define DIR_SE -7
+#define DIR_SW -9
+
+// Direction offsets (N, S, E, W, NE, NW, SE, SW), same order as squares_to_edge
+static const int DIR_OFFSETS[8] = {8, -8, 1, -1, 9, 7, -7, -9};
+
+// ==================== MOVE STRUCTURES ====================
+
+// Lightweight move for fast operations
+struct FastMove {
+    uint8_t from;
+    uint8_t to;
+    uint8_t flags;      // bit 0: capture, bit 1: ep, bit 2: castling, bits 3-5: promotion piece
+    uint8_t captured;
+    int16_t score;      // Move ordering score (used by NeuralNet)
+};
+
+// Full move structure for game history
+struct Move {
+    uint8_t from;
+    uint8_t to;
+    uint8_t captured_piece;
+    uint8_t promotion_piece;
+    bool is_castling;
+    bool is_en_passant;
+    uint8_t en_passant_target_before;
+    uint8_t halfmove_clock_before;
+    uint8_t castling_rights_before;
+    uint64_t hash_before;
+};
+
+// Pre-allocated move list to avoid heap allocations
+struct MoveList {
+    FastMove moves[256];
+    int count;
+
+    inline void clear() { count = 0; }
+    inline void add(uint8_t from, uint8_t to, uint8_t flags = 0, uint8_t captured = 0) {
+        moves[count++] = {from, to, flags, captured, 0};
+    }
+};
+
+// ==================== POSITION (ENGINE CORE) ====================
+
+// Godot-free chess position: board state, move generation, make/unmake and FEN I/O
+// Board (the scene node) builds on this; tools that process many positions
+// (EPD suites, datasets, worker threads) use Position directly. It is plain data,
+// so copying one is a cheap memcpy.
+class Position {
+public:
+    // Board state: 64 squares
+    uint8_t squares[64];
+
+    // Cached king positions for fast lookup
+    uint8_t white_king_pos;
+    uint8_t black_king_pos;
+
+    // ==================== PIECE LIST OPTIMIZATION ====================
+    // Track all piece positions for fast iteration (avoid scanning empty squares)
+    // piece_index[sq] is the slot of sq in its side's list, kept in sync by make/unmake
+    uint8_t white_piece_list[16];  // Max 16 pieces per side
+    uint8_t black_piece_list[16];
+    uint8_t white_piece_count;
+    uint8_t black_piece_count;
+    uint8_t piece_index[64];
+
+    // Game state
+    uint8_t turn;
+
+    // Castling rights: CASTLE_* bits (bit 0=WK, 1=WQ, 2=BK, 3=BQ)
+    uint8_t castling_rights;
+
+    // En passant target square (0-63, or 255 if none). Only set when a pawn of
+    // the side to move could capture there, so that transpositions through a
+    // double push hash the same as through two single pushes
+    uint8_t en_passant_target;
+
+    // Halfmove clock and fullmove number
+    uint8_t halfmove_clock;
+    uint16_t fullmove_number;
+
+    // ==================== ZOBRIST HASHING ====================
+    uint64_t current_hash;
+
+    // ==================== PRECOMPUTED TABLES ====================
+    static bool tables_initialized;
+    static uint8_t knight_attack_squares[64][8];
+    static uint8_t knight_attack_count[64];
+    static uint8_t king_attack_squares[64][8];
+    static uint8_t king_attack_count[64];
+    static uint8_t squares_to_edge[64][8];
+
+    // castling_rights &= castling_mask[from] & castling_mask[to] after any move:
+    // clears the rights tied to a king or rook home square the move touches
+    static uint8_t castling_mask[64];
+
+    // True if a pawn of the side to move stands next to the pawn that just
+    // double-pushed past ep_square (the en passant capture is pseudo-legal)
+    bool en_passant_capturable(uint8_t ep_square) const;
+
+    // Initializes attack tables and Zobrist keys (safe to call repeatedly)
+    static void init_attack_tables();
+
+    Position();
+
+    // ==================== ZOBRIST HELPERS ====================
+    uint64_t calculate_hash() const;
+    int get_zobrist_piece_index(uint8_t piece) const;
+    void hash_piece(uint8_t piece, uint8_t square);
+    void hash_castling(uint8_t old_rights, uint8_t new_rights);
+    void hash_en_passant(uint8_t ep_square);
+    void hash_side();
+
+    // ==================== PIECE LISTS ====================
+    void rebuild_piece_lists();
+    void update_king_cache();
+    inline void add_piece_to_list(uint8_t square, uint8_t piece) {
+        if (IS_WHITE(piece)) {
+            if (white_piece_count < 16) {
+                piece_index[square] = white_piece_count;
+                white_piece_list[white_piece_count++] = square;
+            }
+        } else {
+            if (black_piece_count < 16) {
+                piece_index[square] = black_piece_count;
+                black_piece_list[black_piece_count++] = square;
+            }
+        }
+    }
+    inline void remove_piece_from_list(uint8_t square, uint8_t piece) {
+        uint8_t* list = IS_WHITE(piece) ? white_piece_list : black_piece_list;
+        uint8_t &count = IS_WHITE(piece) ? white_piece_count : black_piece_count;
+        uint8_t slot = piece_index[square];
+        uint8_t last = list[--count];
+        list[slot] = last;
+        piece_index[last] = slot;
+    }
+    inline void move_piece_in_list(uint8_t from, uint8_t to, uint8_t piece) {
+        uint8_t* list = IS_WHITE(piece) ? white_piece_list : black_piece_list;
+        list[piece_index[from]] = to;
+        piece_index[to] = piece_index[from];
+    }
+
+    // ==================== SETUP / FEN ====================
+    void clear_board();
+    void initialize_starting_position();
+
+    // Parses the board fields of a FEN (or the first four fields of an EPD line)
+    // Missing halfmove/fullmove fields default to 0 and 1. On failure the
+    // position is left cleared and false is returned
+    bool parse_fen(std::string_view fen);
+    std::string to_fen() const;
+
+    // "e4" <-> 28. Returns 255 / writes "-" for invalid squares
+    static uint8_t parse_square(std::string_view text);
+    static void square_name(uint8_t square, char out[3]);
+
+    // ==================== ATTACKS / LEGALITY ====================
+    bool is_square_attacked_fast(uint8_t pos, uint8_t attacking_color) const;
+    bool is_king_in_check(uint8_t color) const;
+    bool has_legal_moves() const;
+
+    // ==================== DRAWS BY MATERIAL ====================
+    // Both are O(1): only positions with at most four pieces (kings included)
+    // are inspected, through the piece lists
+    // Neither side can ever mate: KvK, KNvK, KBvK, KBvKB with same-coloured bishops
+    bool is_insufficient_material() const;
+    // Also the configurations that can't be won against correct defence
+    // (KNNvK, minor piece against minor piece). A search score, not a game result
+    bool is_drawish_material() const;
+    void generate_legal_moves(MoveList &moves);
+
+    // ==================== MOVE GENERATION ====================
+    // Dispatches once on the side to move to the colour-templated generators
+    void generate_all_pseudo_legal(MoveList &moves) const;
+
+    // Fast make/unmake for search (no history record)
+    // Dispatch on the moving piece's colour; loops that already know the side
+    // (perft, legality filtering) call the templated versions directly
+    void make_move_fast(const FastMove &m);
+    void unmake_move_fast(const FastMove &m, uint8_t ep_before, uint8_t castling_before, uint64_t hash_before);
+
+    // Make/unmake with a full undo record (clocks included) for game history
+    // Promotions are applied by the caller after make_move_internal
+    void make_move_internal(uint8_t from, uint8_t to, Move &move_record);
+    void revert_move_internal(const Move &move);
+
+    // Resolve a SAN move ("Nbd7", "exd8=Q+", "O-O") against the legal moves
+    // Returns false if it is malformed, illegal or ambiguous
+    bool parse_san(std::string_view san, FastMove &move);
+
+    // Make a generated move with clocks and promotion applied (no undo record kept)
+    void play_move(const FastMove &m);
+
+    // Copy-make: the position after m, leaving this one untouched. Needs no
+    // restore state, so threads can each expand their own copies of a shared
+    // parent (a Position is under 200 bytes)
+    Position after(const FastMove &m) const;
+
+    // ==================== PERFT ====================
+    uint64_t count_all_moves(uint8_t depth);
+
+    // Same count with copy-make instead of make/unmake (benchmarked against it)
+    uint64_t count_all_moves_copy(uint8_t depth) const;
+
+    // Root moves split over `threads` workers (0 = hardware concurrency),
+    // each expanding copy-made children
+    uint64_t count_all_moves_parallel(uint8_t depth, int threads) const;
+
+    // ==================== STATE VERIFICATION ====================
+    // Recomputes all incrementally maintained state from `squares` and compares.
+    // Returns true if consistent, otherwise describes the first mismatch in error
+    bool verify_state(std::string *error = nullptr) const;
+
+    // verify_state() that prints the mismatch and the FEN to stderr and aborts
+    // (called through VERIFY_STATE)
+    void check_state(const char *where) const;
+
+    // True in builds with CHESS_VERIFY_STATE
+    static constexpr bool state_verification_enabled() {
+#ifdef CHESS_VERIFY_STATE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // ==================== STATE ACCESS ====================
+    uint64_t get_hash() const { return current_hash; }
+    const uint8_t* get_squares() const { return squares; }
+    uint8_t get_castling_rights() const { return castling_rights; }
+    uint8_t get_en_passant_target() const { return en_passant_target; }
+    uint8_t get_white_king_pos() const { return white_king_pos; }
+    uint8_t get_black_king_pos() const { return black_king_pos; }
+
+    // Piece list access for optimized iteration
+    const uint8_t* get_white_piece_list() const { return white_piece_list; }
+    const uint8_t* get_black_piece_list() const { return black_piece_list; }
+    uint8_t get_white_piece_count() const { return white_piece_count; }
+    uint8_t get_black_piece_count() const { return black_piece_count; }
+
+    inline uint8_t get_king_pos(uint8_t color) const {
+        return (color == 0) ? white_king_pos : black_king_pos;
+    }
+
+private:
+    // ==================== COLOUR-TEMPLATED CORE ====================
+    // Us / Them are side indices as in `turn` (0 = white, 1 = black), so pawn
+    // direction, promotion rank, castling squares and enemy colour fold into
+    // constants. Defined and instantiated in position.cpp only
+    template <uint8_t Us> inline uint8_t &king_pos_of() { return Us == 0 ? white_king_pos : black_king_pos; }
+
+    template <uint8_t Them> bool square_attacked_by(uint8_t pos) const;
+
+    template <uint8_t Us> inline void generate_pawn_moves(uint8_t pos, MoveList &moves) const;
+    template <uint8_t Us> inline void generate_step_moves(uint8_t pos, const uint8_t (&targets)[64][8], const uint8_t (&target_count)[64], MoveList &moves) const;
+    template <uint8_t Us> inline void generate_slider_moves(uint8_t pos, int first_dir, int last_dir, MoveList &moves) const;
+    template <uint8_t Us> inline void generate_castling_moves(uint8_t pos, MoveList &moves) const;
+    template <uint8_t Us> void generate_pseudo_legal(MoveList &moves) const;
+    template <uint8_t Us> void generate_legal(MoveList &moves);
+    template <uint8_t Us> bool has_legal_moves_for();
+
+    template <uint8_t Us> void make_move(const FastMove &m);
+    template <uint8_t Us> void unmake_move(const FastMove &m, uint8_t ep_before, uint8_t castling_before, uint64_t hash_before);
+
+    template <uint8_t Us> uint64_t perft(uint8_t depth);
+    template <uint8_t Us> uint64_t perft_copy(uint8_t depth) const;
+};
+
+// ==================== EPD ====================
+
+// Largest perft depth recorded from D1..D6 opcodes
+#define EPD_MAX_PERFT_DEPTH 6
+
+// Opcodes of one EPD record that the engine understands
+// Move lists are kept as written (SAN, space separated)
+struct EpdOps {
+    std::string id;
+    std::string comment;        // c0
+    std::string best_moves;     // bm
+    std::string avoid_moves;    // am
+    uint64_t perft[EPD_MAX_PERFT_DEPTH + 1];  // perft[d] from "Dd n", 0 if absent
+
+    EpdOps() { clear(); }
+    void clear() {
+        id.clear();
+        comment.clear();
+        best_moves.clear();
+        avoid_moves.clear();
+        memset(perft, 0, sizeof(perft));
+    }
+};
+
+namespace Epd {
+
+// Parses one EPD line ("<4 FEN fields> [hmvc fmvn] op arg; op arg; ...").
+// Plain 6-field FEN lines are accepted too. ops may be nullptr
+bool parse_line(std::string_view line, Position &pos, EpdOps *ops);
+
+// Reads a whole EPD/FEN file in one pass. Blank lines and lines starting
+// with '#' are skipped; malformed lines are counted in *errors
+// Returns the number of positions appended, or -1 if the file can't be read
+int64_t load_file(const char *path, std::vector<Position> &positions,
+                  std::vector<EpdOps> *ops, uint64_t *errors);
+
+} // namespace Epd
+
+#endif // POSITION_H
@@ -4,6 +4,10 @@
 #include "board.h"
 #include "neural_network.h"
 #include "agent.h"
+#include "dataset_tools.h"
+#include "replay_buffer.h"
+#include "benchmark.h"
+#include "engine_metrics.h"
 
 #include <gdextension_interface.h>
 #include <godot_cpp/core/defs.hpp>
@@ -20,12 +24,20 @@ void initialize_chess_ai_module(ModuleInitializationLevel p_level) {
     ClassDB::register_class<Board>();
     ClassDB::register_class<NeuralNet>();
     ClassDB::register_class<Agent>();
+    ClassDB::register_class<DatasetTools>();
+    ClassDB::register_class<ReplayBuffer>();
+    ClassDB::register_class<Benchmark>();
+
+    // Engine throughput counters for the debugger's Monitors tab
+    EngineMetrics::register_monitors();
 }
 
 void uninitialize_chess_ai_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+
+    EngineMetrics::unregister_monitors();
 }
 
 extern "C" {
@@ -0,0 +1,205 @@
+#include "replay_buffer.h"
+#include "board.h"
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+
+using namespace godot;
+
+// Priorities are kept strictly positive so every entry stays reachable
+static const float MIN_PRIORITY = 1e-6f;
+
+void ReplayBuffer::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_capacity", "capacity"), &ReplayBuffer::set_capacity);
+    ClassDB::bind_method(D_METHOD("get_capacity"), &ReplayBuffer::get_capacity);
+    ClassDB::bind_method(D_METHOD("set_eviction_policy", "policy"), &ReplayBuffer::set_eviction_policy);
+    ClassDB::bind_method(D_METHOD("get_eviction_policy"), &ReplayBuffer::get_eviction_policy);
+    ClassDB::bind_method(D_METHOD("set_prioritized", "enabled"), &ReplayBuffer::set_prioritized);
+    ClassDB::bind_method(D_METHOD("is_prioritized"), &ReplayBuffer::is_prioritized);
+    ClassDB::bind_method(D_METHOD("set_seed", "seed"), &ReplayBuffer::set_seed);
+
+    ClassDB::bind_method(D_METHOD("add", "board", "target", "color", "priority"), &ReplayBuffer::add, DEFVAL(1.0f));
+    ClassDB::bind_method(D_METHOD("clear"), &ReplayBuffer::clear);
+    ClassDB::bind_method(D_METHOD("get_size"), &ReplayBuffer::get_size);
+    ClassDB::bind_method(D_METHOD("update_priorities", "slots", "priorities"), &ReplayBuffer::update_priorities);
+    ClassDB::bind_method(D_METHOD("get_entry", "slot"), &ReplayBuffer::get_entry);
+    ClassDB::bind_method(D_METHOD("sample", "batch_size"), &ReplayBuffer::sample);
+}
+
+ReplayBuffer::ReplayBuffer()
+    : capacity(0), eviction_policy(REPLAY_EVICT_FIFO), prioritized(false),
+      count(0), next_fifo_slot(0), offered(0), leaf_base(1), rng(0x5EED) {
+    set_capacity(100000);
+}
+
+// ==================== CONFIGURATION ====================
+
+void ReplayBuffer::set_capacity(int p_capacity) {
+    if (p_capacity <= 0) {
+        UtilityFunctions::print("Error: Replay buffer capacity must be positive");
+        return;
+    }
+
+    capacity = static_cast<uint32_t>(p_capacity);
+    positions.assign(capacity, PackedPosition());
+    targets.assign(capacity, 0.0f);
+    colors.assign(capacity, COLOR_WHITE);
+    hashes.assign(capacity, 0);
+
+    leaf_base = 1;
+    while (leaf_base < capacity) leaf_base <<= 1;
+
+    clear();
+}
+
+void ReplayBuffer::set_eviction_policy(int policy) {
+    if (policy != REPLAY_EVICT_FIFO && policy != REPLAY_EVICT_RESERVOIR) {
+        UtilityFunctions::print("Error: Unknown replay eviction policy ", policy);
+        return;
+    }
+    eviction_policy = policy;
+}
+
+void ReplayBuffer::clear() {
+    count = 0;
+    next_fifo_slot = 0;
+    offered = 0;
+    slot_of_hash.clear();
+    slot_of_hash.reserve(capacity);
+    priority_tree.assign(2 * static_cast<size_t>(leaf_base), 0.0);
+}
+
+// ==================== CONTENT ====================
+
+void ReplayBuffer::set_priority(uint32_t slot, float priority) {
+    size_t node = leaf_base + slot;
+    double delta = static_cast<double>(std::max(priority, MIN_PRIORITY)) - priority_tree[node];
+    while (node >= 1) {
+        priority_tree[node] += delta;
+        node >>= 1;
+    }
+}
+
+void ReplayBuffer::write_slot(uint32_t slot, const Position &pos, float target, uint8_t color, float priority) {
+    pack_position(pos, positions[slot]);
+    targets[slot] = target;
+    colors[slot] = color;
+    hashes[slot] = pos.current_hash;
+    slot_of_hash[pos.current_hash] = slot;
+    set_priority(slot, priority);
+}
+
+int ReplayBuffer::add_position(const Position &pos, float target, uint8_t color, float priority) {
+    // Known position: keep the newest label in place
+    auto existing = slot_of_hash.find(pos.current_hash);
+    if (existing != slot_of_hash.end()) {
+        uint32_t slot = existing->second;
+        targets[slot] = target;
+        colors[slot] = color;
+        set_priority(slot, priority);
+        return static_cast<int>(slot);
+    }
+
+    offered++;
+
+    uint32_t slot;
+    if (count < capacity) {
+        slot = count++;
+    } else {
+        if (eviction_policy == REPLAY_EVICT_RESERVOIR) {
+            // Keep each of the `offered` positions with probability capacity / offered
+            uint64_t pick = rng() % offered;
+            if (pick >= capacity) return -1;
+            slot = static_cast<uint32_t>(pick);
+        } else {
+            slot = next_fifo_slot;
+            next_fifo_slot = (next_fifo_slot + 1) % capacity;
+        }
+        slot_of_hash.erase(hashes[slot]);
+    }
+    write_slot(slot, pos, target, color, priority);
+    return static_cast<int>(slot);
+}
+
+int ReplayBuffer::add(Board *board, float target, int color, float priority) {
+    if (!board) {
+        UtilityFunctions::print("Error: ReplayBuffer.add needs a board");
+        return -1;
+    }
+    if (color != COLOR_WHITE && color != COLOR_BLACK) {
+        UtilityFunctions::print("Error: Invalid color ", color, " (use COLOR_WHITE or COLOR_BLACK)");
+        return -1;
+    }
+    return add_position(*board, target, static_cast<uint8_t>(color), priority);
+}
+
+void ReplayBuffer::update_priorities(const PackedInt32Array &slots, const PackedFloat32Array &priorities) {
+    if (slots.size() != priorities.size()) {
+        UtilityFunctions::print("Error: slots and priorities arrays must have the same size");
+        return;
+    }
+    for (int64_t i = 0; i < slots.size(); i++) {
+        int32_t slot = slots[i];
+        if (slot >= 0 && static_cast<uint32_t>(slot) < count) {
+            set_priority(static_cast<uint32_t>(slot), priorities[i]);
+        }
+    }
+}
+
+Dictionary ReplayBuffer::get_entry(int slot) const {
+    Dictionary entry;
+    if (slot < 0 || static_cast<uint32_t>(slot) >= count) return entry;
+
+    Position pos;
+    if (unpack_position(positions[slot], pos)) {
+        entry["fen"] = String(pos.to_fen().c_str());
+    }
+    entry["target"] = targets[slot];
+    entry["color"] = colors[slot];
+    entry["priority"] = priority_tree[leaf_base + slot];
+    return entry;
+}
+
+// ==================== SAMPLING ====================
+
+uint32_t ReplayBuffer::sample_prioritized() {
+    std::uniform_real_distribution<double> uniform(0.0, priority_tree[1]);
+    double r = uniform(rng);
+
+    size_t node = 1;
+    while (node < leaf_base) {
+        size_t left = node * 2;
+        if (r < priority_tree[left]) {
+            node = left;
+        } else {
+            r -= priority_tree[left];
+            node = left + 1;
+        }
+    }
+
+    // Rounding can step one leaf past the used range
+    uint32_t slot = static_cast<uint32_t>(node - leaf_base);
+    return slot < count ? slot : count - 1;
+}
+
+void ReplayBuffer::sample_slots(int batch_size, std::vector<uint32_t> &out) {
+    out.clear();
+    if (count == 0 || batch_size <= 0) return;
+
+    out.reserve(batch_size);
+    for (int i = 0; i < batch_size; i++) {
+        out.push_back(prioritized ? sample_prioritized() : static_cast<uint32_t>(rng() % count));
+    }
+}
+
+PackedInt32Array ReplayBuffer::sample(int batch_size) {
+    std::vector<uint32_t> slots;
+    sample_slots(batch_size, slots);
+
+    PackedInt32Array result;
+    result.resize(slots.size());
+    int32_t *data = result.ptrw();
+    for (size_t i = 0; i < slots.size(); i++) {
+        data[i] = static_cast<int32_t>(slots[i]);
+    }
+    return result;
+}
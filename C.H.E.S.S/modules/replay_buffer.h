@@ -0,0 +1,110 @@
+#ifndef REPLAY_BUFFER_H
+#define REPLAY_BUFFER_H
+
+#include "dataset.h"
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace godot;
+
+class Board;
+
+// Eviction policy once the buffer is full
+#define REPLAY_EVICT_FIFO      0   // Overwrite the oldest entry
+#define REPLAY_EVICT_RESERVOIR 1   // Keep a uniform sample of everything added (Algorithm R)
+
+// ==================== REPLAY BUFFER ====================
+
+// Fixed-capacity store of training positions (packed, 36 bytes each) with
+// targets, used to train on decorrelated mini-batches instead of the moves of
+// one game in order. Positions are deduplicated by Zobrist hash: adding a
+// position that is already stored replaces its target, perspective and priority.
+//
+//   var buffer = ReplayBuffer.new()
+//   buffer.add(board, target, COLOR_WHITE)
+//   agent.train_on_replay_buffer(buffer, 32, 0.001)
+class ReplayBuffer : public RefCounted {
+    GDCLASS(ReplayBuffer, RefCounted)
+
+private:
+    uint32_t capacity;
+    int eviction_policy;
+    bool prioritized;
+
+    // Entry storage (parallel arrays, `count` entries used)
+    std::vector<PackedPosition> positions;
+    std::vector<float> targets;
+    std::vector<uint8_t> colors;        // Perspective the target is for (COLOR_WHITE / COLOR_BLACK)
+    std::vector<uint64_t> hashes;
+    uint32_t count;
+    uint32_t next_fifo_slot;
+    uint64_t offered;                   // New positions offered since clear (reservoir sampling)
+
+    std::unordered_map<uint64_t, uint32_t> slot_of_hash;
+
+    // Sum tree over priorities: leaves at [leaf_base + slot], parents hold sums
+    std::vector<double> priority_tree;
+    uint32_t leaf_base;
+
+    std::mt19937_64 rng;
+
+    void set_priority(uint32_t slot, float priority);
+    uint32_t sample_prioritized();
+    void write_slot(uint32_t slot, const Position &pos, float target, uint8_t color, float priority);
+
+protected:
+    static void _bind_methods();
+
+public:
+    ReplayBuffer();
+
+    // ==================== CONFIGURATION ====================
+    // Changing the capacity clears the buffer
+    void set_capacity(int p_capacity);
+    int get_capacity() const { return static_cast<int>(capacity); }
+
+    // REPLAY_EVICT_FIFO (0) or REPLAY_EVICT_RESERVOIR (1)
+    void set_eviction_policy(int policy);
+    int get_eviction_policy() const { return eviction_policy; }
+
+    // Sample proportionally to priority instead of uniformly
+    void set_prioritized(bool enabled) { prioritized = enabled; }
+    bool is_prioritized() const { return prioritized; }
+
+    void set_seed(int64_t seed) { rng.seed(static_cast<uint64_t>(seed)); }
+
+    // ==================== CONTENT ====================
+    // Stores the board's current position. Returns the slot used, or -1 if
+    // reservoir sampling dropped it
+    int add(Board *board, float target, int color, float priority = 1.0f);
+
+    // Native variant for C++ producers
+    int add_position(const Position &pos, float target, uint8_t color, float priority = 1.0f);
+
+    void clear();
+    int get_size() const { return static_cast<int>(count); }
+
+    // Change priorities of sampled slots (e.g. to the latest training loss)
+    void update_priorities(const PackedInt32Array &slots, const PackedFloat32Array &priorities);
+
+    // {fen, target, color, priority} of one slot (debugging / inspection)
+    Dictionary get_entry(int slot) const;
+
+    // ==================== SAMPLING ====================
+    // Draws batch_size slots with replacement (uniform or by priority)
+    PackedInt32Array sample(int batch_size);
+    void sample_slots(int batch_size, std::vector<uint32_t> &out);
+
+    const PackedPosition &get_packed(uint32_t slot) const { return positions[slot]; }
+    float get_target(uint32_t slot) const { return targets[slot]; }
+    uint8_t get_color(uint32_t slot) const { return colors[slot]; }
+};
+
+#endif // REPLAY_BUFFER_H
@@ -0,0 +1,178 @@
+#include "trace.h"
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace godot;
+
+namespace Trace {
+
+std::atomic<bool> enabled{false};
+
+// One ring per live thread. Only the owning thread writes events/head, so
+// recording needs no locks; readers use head (acquire) to find the published
+// events and `writing` to drop slots the owner overwrote while they were copied
+struct ThreadBuffer {
+    Event events[RING_CAPACITY];
+    std::atomic<uint64_t> head;     // Total events ever written
+    std::atomic<uint64_t> tail;     // Events before this index were cleared
+    std::atomic<uint64_t> writing;  // Index of the event being written (announced before its slot changes)
+    uint32_t thread_index;
+
+    ThreadBuffer(uint32_t index) : head(0), tail(0), writing(0), thread_index(index) {}
+};
+
+// Registry of all buffers; the mutex is only taken when a thread starts or exits
+// and when dumping. Buffers are never freed, only reused through free_buffers
+static std::mutex registry_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> registry;
+static std::vector<ThreadBuffer*> free_buffers;
+
+// Returns the thread's buffer to the free list when the thread exits
+struct BufferOwner {
+    ThreadBuffer* buffer = nullptr;
+
+    ~BufferOwner() {
+        if (!buffer) return;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        free_buffers.push_back(buffer);
+    }
+};
+
+static thread_local BufferOwner local_owner;
+
+static ThreadBuffer* get_local_buffer() {
+    if (!local_owner.buffer) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        if (!free_buffers.empty()) {
+            local_owner.buffer = free_buffers.back();
+            free_buffers.pop_back();
+        } else {
+            registry.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(registry.size())));
+            local_owner.buffer = registry.back().get();
+        }
+    }
+    return local_owner.buffer;
+}
+
+void set_enabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+uint64_t now_ns() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+}
+
+void record(const char* name, uint64_t start_ns, uint64_t duration_ns, int64_t arg) {
+    ThreadBuffer* buffer = get_local_buffer();
+
+    // Announce the overwrite before touching the slot (pairs with the reader's fence in dump)
+    uint64_t h = buffer->head.load(std::memory_order_relaxed);
+    buffer->writing.store(h, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Event &e = buffer->events[h % RING_CAPACITY];
+    e.name = name;
+    e.start_ns = start_ns;
+    e.duration_ns = duration_ns;
+    e.arg = arg;
+    buffer->head.store(h + 1, std::memory_order_release);
+}
+
+void clear() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto &buffer : registry) {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+// First readable event index of a buffer (older events were overwritten or cleared)
+static uint64_t first_event(const ThreadBuffer &buffer, uint64_t head) {
+    uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+    uint64_t oldest = (head > RING_CAPACITY) ? head - RING_CAPACITY : 0;
+    return std::max(tail, oldest);
+}
+
+uint64_t event_count() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    uint64_t total = 0;
+    for (auto &buffer : registry) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        total += head - first_event(*buffer, head);
+    }
+    return total;
+}
+
+bool dump_chrome_trace(const char* path) {
+    Ref<FileAccess> file = FileAccess::open(String::utf8(path), FileAccess::WRITE);
+    if (file.is_null()) {
+        UtilityFunctions::print("Error: Cannot open trace file for writing: ", path);
+        return false;
+    }
+
+    // Events are formatted into a chunk and flushed to the file once it grows large
+    std::string chunk;
+    chunk.reserve(1 << 20);
+    auto flush_chunk = [&]() {
+        file->store_string(String::utf8(chunk.c_str(), static_cast<int>(chunk.size())));
+        chunk.clear();
+    };
+
+    chunk += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    char line[256];
+
+    std::vector<Event> snapshot;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto &buffer : registry) {
+        // Copy the published events, then drop those whose slot the owner started
+        // to overwrite meanwhile (event i shares its slot with i + RING_CAPACITY)
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = first_event(*buffer, head);
+        snapshot.clear();
+        for (uint64_t i = begin; i < head; i++) {
+            snapshot.push_back(buffer->events[i % RING_CAPACITY]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t writing = buffer->writing.load(std::memory_order_relaxed);
+        uint64_t valid = (writing >= RING_CAPACITY) ? writing - RING_CAPACITY + 1 : 0;
+        size_t skip = static_cast<size_t>(std::min<uint64_t>(std::max(valid, begin) - begin, snapshot.size()));
+
+        // Thread name metadata so the viewer labels each row
+        snprintf(line, sizeof(line),
+                 "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                 first ? "" : ",\n", buffer->thread_index, buffer->thread_index);
+        chunk += line;
+        first = false;
+
+        for (size_t i = skip; i < snapshot.size(); i++) {
+            const Event &e = snapshot[i];
+
+            // Complete ("X") events with microsecond timestamps
+            snprintf(line, sizeof(line),
+                     ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"value\":%lld}}",
+                     e.name, buffer->thread_index, e.start_ns / 1000.0, e.duration_ns / 1000.0,
+                     static_cast<long long>(e.arg));
+            chunk += line;
+
+            if (chunk.size() > (1 << 20) - 512) flush_chunk();
+        }
+    }
+
+    chunk += "\n]}\n";
+    flush_chunk();
+    file->close();
+
+    UtilityFunctions::print("Trace written to ", path);
+    return true;
+}
+
+} // namespace Trace
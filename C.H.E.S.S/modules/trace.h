@@ -0,0 +1,83 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lightweight span tracing for search and training phases
+//
+// Compile-time: build with `scons trace=yes` (defines CHESS_TRACE), otherwise
+// the TRACE_* macros compile to nothing.
+// Run-time: recording only happens while Trace::set_enabled(true).
+//
+// Each thread writes into its own fixed-size ring buffer (single producer, no
+// locks on the hot path). A thread's buffer goes back to a free list when the
+// thread exits and is handed to the next new thread, so short-lived workers do
+// not add a buffer each. dump_chrome_trace() writes every buffer as Chrome trace
+// JSON, which loads in chrome://tracing and https://ui.perfetto.dev
+namespace Trace {
+
+// Events kept per thread; older events are overwritten when the ring wraps
+static const uint32_t RING_CAPACITY = 65536;
+
+struct Event {
+    const char* name;   // Must point to a string literal (stored, not copied)
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    int64_t arg;
+};
+
+extern std::atomic<bool> enabled;
+
+inline bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+void set_enabled(bool on);
+
+// Nanoseconds since the first call (shared epoch for all threads)
+uint64_t now_ns();
+
+// Append a finished span to the calling thread's ring buffer
+void record(const char* name, uint64_t start_ns, uint64_t duration_ns, int64_t arg);
+
+// Drop all recorded events (buffers stay registered)
+void clear();
+
+// Write all recorded events as Chrome trace JSON
+// Accepts res://, user:// and absolute paths. Returns true on success
+bool dump_chrome_trace(const char* path);
+
+// Number of events currently held across all threads
+uint64_t event_count();
+
+// RAII span: measures from construction to destruction
+class Scope {
+private:
+    const char* name;
+    int64_t arg;
+    uint64_t start;
+
+public:
+    inline explicit Scope(const char* p_name, int64_t p_arg = 0) : name(p_name), arg(p_arg), start(0) {
+        if (is_enabled()) start = now_ns() | 1;  // Low bit marks an active span
+    }
+    inline ~Scope() {
+        if (start) {
+            uint64_t begin = start & ~1ULL;
+            record(name, begin, now_ns() - begin, arg);
+        }
+    }
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef CHESS_TRACE
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, arg) Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name, static_cast<int64_t>(arg))
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, arg) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,52 @@
+#ifndef TRAINING_STATS_H
+#define TRAINING_STATS_H
+
+#include <chrono>
+#include <cstdint>
+
+// Training-loop profiler: cumulative wall time per phase plus work counters.
+// Each NeuralNet owns one (training a network is single-threaded), read with
+// NeuralNet.get_training_stats(). Unlike TRACE_SCOPE spans these are always
+// on, so timers are only placed around whole phases of an example.
+
+#define TRAINING_PHASE_MARSHALLING      0   // GDScript Array -> native feature vector
+#define TRAINING_PHASE_DATA_LOADING     1   // Dataset reads, replay sampling, position unpacking
+#define TRAINING_PHASE_FEATURES         2   // Position -> input features
+#define TRAINING_PHASE_FORWARD          3
+#define TRAINING_PHASE_CLEAR_GRADIENTS  4   // Zeroing gradient buffers before each example
+#define TRAINING_PHASE_BACKPROP         5
+#define TRAINING_PHASE_UPDATE           6   // SGD weight update
+#define TRAINING_PHASE_COUNT            7
+
+// Keys used in get_training_stats()
+inline const char *training_phase_name(int phase) {
+    static const char *const names[TRAINING_PHASE_COUNT] = {
+        "marshalling", "data_loading", "features", "forward", "clear_gradients", "backprop", "update"
+    };
+    return names[phase];
+}
+
+struct TrainingStats {
+    uint64_t phase_ns[TRAINING_PHASE_COUNT] = {};
+    uint64_t examples = 0;
+    uint64_t flops = 0;         // Multiply-adds counted as 2 FLOPs (forward, backprop and update)
+
+    void reset() { *this = TrainingStats(); }
+};
+
+// Adds the lifetime of the scope to one phase
+class PhaseTimer {
+private:
+    uint64_t &total_ns;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    inline PhaseTimer(TrainingStats &stats, int phase)
+        : total_ns(stats.phase_ns[phase]), start(std::chrono::steady_clock::now()) {}
+    inline ~PhaseTimer() {
+        total_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+#endif // TRAINING_STATS_H
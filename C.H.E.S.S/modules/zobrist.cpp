@@ -4,7 +4,7 @@ namespace Zobrist {
 
 // Define the extern variables
 uint64_t piece_keys[12][64];
-uint64_t castling_keys[4];
+uint64_t castling_keys[16];
 uint64_t en_passant_keys[8];
 uint64_t side_key;
 bool initialized = false;
@@ -44,9 +44,16 @@ void init() {
         }
     }
     
-    // Initialize castling keys
+    // Initialize castling keys: one per right, combined for every mask
+    uint64_t right_keys[4];
     for (int i = 0; i < 4; i++) {
-        castling_keys[i] = rng.next();
+        right_keys[i] = rng.next();
+    }
+    for (int mask = 0; mask < 16; mask++) {
+        castling_keys[mask] = 0;
+        for (int i = 0; i < 4; i++) {
+            if (mask & (1 << i)) castling_keys[mask] ^= right_keys[i];
+        }
     }
     
     // Initialize en passant keys (one per file)
@@ -12,9 +12,10 @@ namespace Zobrist {
 // piece_index: 0-5 = White P,N,B,R,Q,K; 6-11 = Black P,N,B,R,Q,K
 extern uint64_t piece_keys[12][64];
 
-// Random numbers for castling rights (4 bits = 16 combinations, but we use 4 individual keys)
-// Index: [0]=WK, [1]=WQ, [2]=BK, [3]=BQ
-extern uint64_t castling_keys[4];
+// Random numbers for castling rights, indexed by the 4-bit CASTLE_* mask so a
+// rights change is one XOR pair. Each entry is the XOR of the keys of its set
+// bits, so hashes match the earlier per-right keys
+extern uint64_t castling_keys[16];
 
 // Random numbers for en passant file (0-7, or no en passant)
 // We only need 8 keys for the file, not 64 for each square
@@ -23,6 +23,8 @@ const LOAD_MODELS_ON_START = true  # Set to true to load existing models
 const LEARNING_RATE = 0.001  # Learning rate for gradient descent
 const TRAIN_EVERY_N_MOVES = 1  # Train after every N moves (1 = train after each move)
 const DISTILLATION_SEARCH_DEPTH = 3  # Depth for tree search in distillation mode
+const REPLAY_CAPACITY = 50000  # Labelled positions kept per agent for distillation
+const REPLAY_BATCH_SIZE = 16  # Positions sampled from the replay buffer per training step
 
 # Piece type constants (must match board.h)
 const PIECE_NONE = 0
@@ -73,8 +75,8 @@ var move_count: int = 0
 var game_finished: bool = false
 
 # Training data
-var training_positions = []  # Stores board positions (feature vectors) from the game
-var training_targets = []    # Stores target values for each position
+# Labelled positions per agent color, sampled in random mini-batches (deduplicated by position)
+var replay_buffers = {}
 var total_training_loss = 0.0
 var num_training_examples = 0
 
@@ -269,10 +271,11 @@ func update_last_move_visuals(start: Vector2i, end: Vector2i):
 
 func refresh_visuals():
 	var active_positions = []
+	var packed = board.get_board_packed()
 	for x in range(8):
 		for y in range(8):
 			var pos = Vector2i(x, y)
-			var data = get_data_at(pos)
+			var data = decode_piece(packed[grid_to_square(pos)])
 			if data.is_empty():
 				if sprites.has(pos):
 					sprites[pos].queue_free()
@@ -331,7 +334,7 @@ func _threaded_ai_search(max_depth: int, color: int):
 
 	# Report the depth actually reached
 	var actual_depth = best_move.get("depth", 0)
-	print("%s Agent completed search to depth %d in %d ms" % [color_name, actual_depth, elapsed])
+	print("%s Agent completed search to depth %d in %d ms (%d nodes)" % [color_name, actual_depth, elapsed, current_agent.get_nodes_searched()])
 
 	# Hand the result back to the main thread
 	call_deferred("_on_ai_search_complete", best_move, color)
@@ -461,28 +464,35 @@ func train_heuristic(agent: Agent, color: int) -> float:
 	# Simply delegate to the agent's built-in method
 	return agent.train_on_current_position(color, LEARNING_RATE)
 
+func get_replay_buffer(color: int) -> ReplayBuffer:
+	"""Replay buffer holding the distillation labels for one agent."""
+	if not replay_buffers.has(color):
+		var buffer = ReplayBuffer.new()
+		buffer.set_capacity(REPLAY_CAPACITY)
+		replay_buffers[color] = buffer
+	return replay_buffers[color]
+
 func train_distillation(agent: Agent, color: int) -> float:
 	"""Train agent using tree search evaluation as target (distillation training)."""
 
-	# 1. Extract features from current position
-	var features = agent.get_features_for_color(color)
-
-	# 2. Perform shallow tree search to get "teacher" evaluation
+	# 1. Perform shallow tree search to get "teacher" evaluation
 	# This search uses the neural network + minimax to get a better evaluation
 	var search_result = agent.run_iterative_deepening(DISTILLATION_SEARCH_DEPTH)
 
 	if search_result.is_empty():
 		return 0.0
 
-	# 3. Get the evaluation score from the search
+	# 2. Get the evaluation score from the search
 	var search_score = search_result.get("score", 0)
 
-	# 4. Convert the search score to a training target (0.0 to 1.0)
+	# 3. Convert the search score to a training target (0.0 to 1.0)
 	var target = agent.score_to_target(search_score)
 
-	# 5. Train the network to match this target
+	# 4. Store the labelled position and train on a random mini-batch of labels
 	# This teaches the network to "distill" the knowledge from tree search
-	var loss = agent.train_single_example(features, target, LEARNING_RATE)
+	var buffer = get_replay_buffer(color)
+	buffer.add(board, target, color)
+	var loss = agent.train_on_replay_buffer(buffer, REPLAY_BATCH_SIZE, LEARNING_RATE)
 
 	return loss
 
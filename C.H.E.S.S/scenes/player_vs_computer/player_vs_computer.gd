@@ -313,10 +313,11 @@ func update_last_move_visuals(start: Vector2i, end: Vector2i):
 
 func refresh_visuals():
 	var active_positions = []
+	var packed = board.get_board_packed()
 	for x in range(8):
 		for y in range(8):
 			var pos = Vector2i(x, y)
-			var data = get_data_at(pos)
+			var data = decode_piece(packed[grid_to_square(pos)])
 			if data.is_empty():
 				if sprites.has(pos):
 					sprites[pos].queue_free()
@@ -458,7 +459,7 @@ func revert_last_move():
 		return
 
 	# In PvC mode, we revert TWO moves (player + AI) to get back to player's turn
-	var moves = board.get_moves()
+	var moves = board.get_moves_uci()
 	if moves.size() == 0:
 		return 
 	
@@ -466,7 +467,7 @@ func revert_last_move():
 	board.revert_move()
 	
 	# Check if there's another move to revert (player's previous move)
-	moves = board.get_moves()
+	moves = board.get_moves_uci()
 	if moves.size() > 0:
 		board.revert_move()
 	
@@ -484,7 +485,7 @@ func revert_last_move():
 		s.queue_free()
 	last_move_sprites.clear()
 	
-	var remaining_moves = board.get_moves()
+	var remaining_moves = board.get_moves_uci()
 	if remaining_moves.size() > 0:
 		var last_uci = remaining_moves[remaining_moves.size() - 1]
 		var prev_move = parse_uci_move(last_uci)
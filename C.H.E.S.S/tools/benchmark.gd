@@ -0,0 +1,45 @@
+extends SceneTree
+
+# Headless runner for the native component benchmarks (see modules/benchmark.h)
+#
+#   godot --headless --path C.H.E.S.S --script res://tools/benchmark.gd -- [--out=PATH] [--filter=NAME] [--seconds=S]
+#
+# --out      JSON report, compare two of them to spot regressions between builds
+# --filter   only benchmarks whose name contains NAME (e.g. movegen, forward, tt_)
+# --seconds  minimum measuring time per benchmark (default 0.25)
+
+func _initialize():
+	var out_path = ""
+	var filter = ""
+	var min_seconds = 0.25
+
+	for arg in OS.get_cmdline_user_args():
+		if arg.begins_with("--out="):
+			out_path = arg.trim_prefix("--out=")
+		elif arg.begins_with("--filter="):
+			filter = arg.trim_prefix("--filter=")
+		elif arg.begins_with("--seconds="):
+			min_seconds = arg.trim_prefix("--seconds=").to_float()
+
+	var report = Benchmark.run(filter, min_seconds)
+	report["engine_version"] = Engine.get_version_info().string
+	report["debug_build"] = OS.is_debug_build()
+	report["timestamp"] = Time.get_datetime_string_from_system(true)
+
+	for result in report.results:
+		var line = "%-34s %12.1f ns/op  (%d ops)" % [result.name, result.ns_per_op, result.ops]
+		if result.has("nodes_per_op"):
+			line += "  %d nodes/op" % result.nodes_per_op
+		print(line)
+
+	if out_path != "":
+		var file = FileAccess.open(out_path, FileAccess.WRITE)
+		if file == null:
+			print("Error: Cannot write benchmark report to ", out_path)
+			quit(1)
+			return
+		file.store_string(JSON.stringify(report, "  "))
+		file.close()
+		print("Report written to ", ProjectSettings.globalize_path(out_path))
+
+	quit()
@@ -0,0 +1,55 @@
+extends SceneTree
+
+# Regression run of the df-pn mate prover (Agent.find_mate, modules/mate_search.h)
+#
+#   godot --headless --path C.H.E.S.S --script res://tools/mate_suite.gd -- [--nodes=N]
+#
+# Each case names the expected status; mate_in > 0 also requires the prover
+# to reach that exact mate and show that no shorter one exists. Exits 1 if
+# any case fails
+
+const CASES = [
+	{"fen": "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", "status": "proven", "mate_in": 1},
+	{"fen": "7k/8/5NKN/8/8/8/8/8 w - - 0 1", "status": "proven", "mate_in": 1},
+	{"fen": "4k3/8/4K3/8/8/8/8/3Q4 w - - 0 1", "status": "proven", "mate_in": 2},
+	{"fen": "2r3k1/p4p2/3Rp2p/1p2P1pK/8/1P4P1/P3Q2P/1q6 b - - 0 1", "status": "proven", "mate_in": 3},
+	# KQ vs K with the defending king in the centre
+	{"fen": "8/8/8/3k4/8/8/8/3QK3 w - - 0 1", "status": "proven", "mate_in": 0},
+	{"fen": "8/8/8/3k4/8/3K4/8/3Q4 w - - 0 1", "status": "proven", "mate_in": 0},
+	{"fen": "8/8/8/4k3/8/8/8/4K2Q w - - 0 1", "status": "proven", "mate_in": 0},
+	{"fen": "8/8/8/4k3/8/8/8/4K3 w - - 0 1", "status": "disproven", "mate_in": 0},
+]
+
+func _initialize():
+	var max_nodes = 1000000
+
+	for arg in OS.get_cmdline_user_args():
+		if arg.begins_with("--nodes="):
+			max_nodes = arg.trim_prefix("--nodes=").to_int()
+
+	var board = Board.new()
+	var agent = Agent.new()
+	agent.set_board(board)
+
+	var failures = 0
+	for case in CASES:
+		board.setup_board(case.fen)
+		var found = agent.find_mate(max_nodes)
+
+		var ok = found.status == case.status
+		if ok and case.status == "proven":
+			ok = not found.moves.is_empty()
+		if ok and case.mate_in > 0:
+			ok = found.mate_in == case.mate_in and found.shortest
+
+		print("%s %-62s %-9s mate_in %2d%s  %d nodes  %.2fs" % [
+			"ok  " if ok else "FAIL", case.fen, found.status, found.mate_in,
+			" (shortest)" if found.shortest else "", found.nodes, found.seconds])
+		if not ok:
+			failures += 1
+
+	agent.free()
+	board.free()
+
+	print("%d/%d mate cases passed" % [CASES.size() - failures, CASES.size()])
+	quit(0 if failures == 0 else 1)
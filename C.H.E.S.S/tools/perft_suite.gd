@@ -0,0 +1,41 @@
+extends SceneTree
+
+# Perft stress run over an EPD suite with D1..D6 node counts
+#
+#   scons verify=yes
+#   godot --headless --path C.H.E.S.S --script res://tools/perft_suite.gd -- [--epd=res://perft.epd] [--depth=4] [--threads=1]
+#
+# The default suite, res://perft.epd, holds the standard start, kiwipete and
+# position 3-6 counts.
+# In a verify=yes build every make/unmake also recomputes the incremental
+# position state and aborts with the FEN on the first mismatch. --threads=N
+# (0 = all cores) counts root moves in parallel with copy-make instead
+
+func _initialize():
+	var epd_path = "res://perft.epd"
+	var max_depth = 4
+	var threads = 1
+
+	for arg in OS.get_cmdline_user_args():
+		if arg.begins_with("--epd="):
+			epd_path = arg.trim_prefix("--epd=")
+		elif arg.begins_with("--depth="):
+			max_depth = arg.trim_prefix("--depth=").to_int()
+		elif arg.begins_with("--threads="):
+			threads = arg.trim_prefix("--threads=").to_int()
+
+	var board = Board.new()
+	if board.load_epd(epd_path) < 0:
+		board.free()
+		quit(1)
+		return
+
+	var report = board.run_epd_perft(max_depth, threads)
+	board.free()
+
+	print("%d perft counts checked, %d nodes in %.1fs (state verification %s)" % [
+		report.checked, report.nodes, report.seconds, "on" if report.state_verification else "off"])
+	for failure in report.failures:
+		print("FAIL position %d depth %d: expected %d, got %d" % [failure.index, failure.depth, failure.expected, failure.actual])
+
+	quit(0 if report.failures.is_empty() else 1)